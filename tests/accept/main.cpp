@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <vector>
+
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+
+/*
+Accept rate benchmark, simulate reconnect storm: connect lots of clients at once,
+and measure how long the server take to accept all of them with different accept params.
+usage: accepttest [clients], default 2000 clients, i.e. accepttest 5000 for a larger storm
+*/
+
+namespace accepttest
+{
+enum
+{
+  SERVER_PORT = 30002,
+};
+
+static double run(int clients, int backlog, int max_accepts)
+{
+  io_hostent endpoint{"127.0.0.1", SERVER_PORT};
+  io_service server(&endpoint, 1);
+  server.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+  server.set_option(YOPT_C_ACCEPT_PARAMS, 0, backlog, max_accepts);
+
+  // don't print the connection established logs
+  print_fn2_t quiet = [](int level, const char* msg) {
+    if (level >= YLOG_W)
+      fputs(msg, stdout);
+  };
+  server.set_option(YOPT_S_PRINT_FN2, &quiet);
+
+  std::atomic<int> accepted{0};
+  server.start([&](event_ptr&& ev) {
+    if (ev->kind() == YEK_ON_OPEN && ev->status() == 0)
+      ++accepted;
+  });
+  server.open(0, YCK_TCP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  std::vector<xxsocket> socks(clients);
+  ip::endpoint ep("127.0.0.1", SERVER_PORT);
+  auto start = highp_clock();
+  for (auto& sock : socks)
+    sock.pconnect_n(ep);
+
+  // the dropped SYN will be retransmitted by client kernel after 1s, 2s, 4s...
+  auto deadline = start + std::chrono::microseconds(std::chrono::seconds(10)).count();
+  while (accepted < clients && highp_clock() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  auto elapsed = (highp_clock() - start) / 1000.0;
+
+  printf("backlog=%-5d max_accepts=%-3d accepted=%d/%d, cost: %.3lf(ms), rate: %.1lf(conn/s)\n", backlog, max_accepts, (int)accepted, clients, elapsed,
+         accepted * 1000.0 / elapsed);
+
+  socks.clear();
+  server.stop();
+  return elapsed;
+}
+} // namespace accepttest
+
+int main(int argc, char** argv)
+{
+  int clients = argc > 1 ? atoi(argv[1]) : 2000;
+
+  accepttest::run(clients, YASIO_SOMAXCONN, 1); // the legacy behavior: one accept per event loop
+  accepttest::run(clients, YASIO_SOMAXCONN, 0);
+  accepttest::run(clients, 4096, 1);
+  accepttest::run(clients, 4096, 0);
+
+  return 0;
+}
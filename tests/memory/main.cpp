@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <vector>
+#if defined(__linux__)
+#  include <unistd.h>
+#endif
+
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+
+/*
+Memory per connection benchmark: connect lots of idle clients to server, and measure the
+resident memory growth of process per connection at different stages:
+  - idle: connections established, no data received
+  - read: each connection received one packet, and then idle again
+  - partial: each connection received a partial frame header, the frame pending
+usage: memorytest [clients]
+*/
+
+namespace memorytest
+{
+enum
+{
+  SERVER_PORT = 30005,
+};
+
+struct memory_usage {
+  long long virt     = 0; // the virtual memory size, the untouched pages of allocations counted
+  long long resident = 0;
+};
+static memory_usage get_memory_usage()
+{
+  memory_usage usage;
+#if defined(__linux__)
+  if (FILE* fp = fopen("/proc/self/statm", "r"))
+  {
+    if (fscanf(fp, "%lld %lld", &usage.virt, &usage.resident) == 2)
+    {
+      usage.virt *= sysconf(_SC_PAGESIZE);
+      usage.resident *= sysconf(_SC_PAGESIZE);
+    }
+    fclose(fp);
+  }
+#endif
+  return usage; // other platforms: not supported
+}
+
+template <typename _Pred>
+static bool wait_until(_Pred pred)
+{
+  auto deadline = highp_clock() + std::chrono::microseconds(std::chrono::seconds(10)).count();
+  while (!pred() && highp_clock() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  return pred();
+}
+
+static void run(int clients)
+{
+  io_hostent endpoint{"127.0.0.1", SERVER_PORT};
+  io_service server(&endpoint, 1);
+  server.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+  server.set_option(YOPT_C_ACCEPT_PARAMS, 0, 4096, 0);
+  server.set_option(YOPT_C_UNPACK_PARAMS, 0, 65536, 0, 4, 0);
+
+  // don't print the connection established logs
+  print_fn2_t quiet = [](int level, const char* msg) {
+    if (level >= YLOG_W)
+      fputs(msg, stdout);
+  };
+  server.set_option(YOPT_S_PRINT_FN2, &quiet);
+
+  std::atomic<int> accepted{0}, packets{0};
+  server.start([&](event_ptr&& ev) {
+    if (ev->kind() == YEK_ON_OPEN && ev->status() == 0)
+      ++accepted;
+    else if (ev->kind() == YEK_ON_PACKET)
+      ++packets;
+  });
+  server.open(0, YCK_TCP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  auto report = [clients](const char* stage, const memory_usage& base) {
+    auto usage = get_memory_usage();
+    auto virt = usage.virt - base.virt, resident = usage.resident - base.resident;
+    printf("stage=%-8s clients=%d, virtual: %.1lf(MB), resident: %.1lf(MB), per connection: %.2lf/%.2lf(KB)\n", stage, clients, virt / 1048576.0,
+           resident / 1048576.0, virt / 1024.0 / clients, resident / 1024.0 / clients);
+  };
+
+  auto base = get_memory_usage();
+  std::vector<xxsocket> socks(clients);
+  ip::endpoint ep("127.0.0.1", SERVER_PORT);
+  for (auto& sock : socks)
+    sock.pconnect_n(ep);
+  if (!wait_until([&] { return accepted == clients; }))
+    printf("accepted=%d/%d, timeout\n", (int)accepted, clients);
+  report("idle", base);
+
+  // a 1KB packet per connection
+  std::vector<char> packet(1024, 'x');
+  uint32_t length = htonl(static_cast<uint32_t>(packet.size()));
+  memcpy(packet.data(), &length, sizeof(length));
+  for (auto& sock : socks)
+    sock.send(packet.data(), static_cast<int>(packet.size()));
+  if (!wait_until([&] { return packets == clients; }))
+    printf("packets=%d/%d, timeout\n", (int)packets, clients);
+  report("read", base);
+
+  // the first 2 bytes of frame header, the transport holds the pending bytes
+  for (auto& sock : socks)
+    sock.send(packet.data(), 2);
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  report("partial", base);
+
+  socks.clear();
+  server.stop();
+}
+} // namespace memorytest
+
+int main(int argc, char** argv)
+{
+  int clients = argc > 1 ? atoi(argv[1]) : 2000;
+
+  memorytest::run(clients);
+
+  return 0;
+}
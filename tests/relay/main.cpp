@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+
+/*
+TCP relay example & benchmark: source --> relay(io_service) --> sink
+The relay accepts the source connection, connects to the sink, and forwards the bytes with:
+  - copy: the legacy way, recv to transport buffer, dispatch YEK_ON_PACKET, and write the copied packet to peer
+  - relay: io_service::relay, splice the bytes through pipes in kernel side on linux
+usage: relaytest [MBytes]
+*/
+
+namespace relaytest
+{
+enum
+{
+  RELAY_PORT = 30003,
+  SINK_PORT  = 30004,
+};
+
+static void run(bool kernel_relay, long long total_bytes)
+{
+  io_hostent endpoints[] = {{"127.0.0.1", RELAY_PORT}, {"127.0.0.1", SINK_PORT}};
+  io_service relay(endpoints, 2);
+  relay.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+
+  // don't print the connection established logs
+  print_fn2_t quiet = [](int level, const char* msg) {
+    if (level >= YLOG_W)
+      fputs(msg, stdout);
+  };
+  relay.set_option(YOPT_S_PRINT_FN2, &quiet);
+
+  // copy mode: dispatch all received bytes as packet
+  decode_len_fn_t raw_decode = [](void*, int n) { return n; };
+  relay.set_option(YOPT_C_UNPACK_FN, 0, &raw_decode);
+  relay.set_option(YOPT_C_UNPACK_FN, 1, &raw_decode);
+
+  transport_handle_t client = nullptr, backend = nullptr;
+  std::atomic<bool> ready{false};
+  relay.start([&](event_ptr&& ev) {
+    switch (ev->kind())
+    {
+      case YEK_ON_OPEN:
+        if (ev->status() != 0)
+          break;
+        if (ev->cindex() == 0)
+        { // source connected, connect to sink
+          client = ev->transport();
+          relay.open(1, YCK_TCP_CLIENT);
+        }
+        else
+        {
+          backend = ev->transport();
+          if (kernel_relay)
+            relay.relay(client, backend);
+          ready = true;
+        }
+        break;
+      case YEK_ON_PACKET: // copy mode only
+        if (auto peer = ev->cindex() == 0 ? backend : client)
+          relay.write(peer, std::move(ev->packet()));
+        break;
+      case YEK_ON_CLOSE: // the relay pair closed together by io_service::relay, in copy mode, the pair closed at relay.stop()
+        if (ev->cindex() == 0)
+          client = nullptr;
+        else
+          backend = nullptr;
+        break;
+    }
+  });
+
+  xxsocket listener;
+  listener.pserve(ip::endpoint("127.0.0.1", SINK_PORT));
+  relay.open(0, YCK_TCP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  long long received = 0;
+  highp_time_t finish_time = 0;
+  std::thread sink([&] {
+    auto s = listener.accept();
+    std::vector<char> buf(256 * 1024);
+    int n;
+    while (received < total_bytes && (n = s.recv(buf.data(), static_cast<int>(buf.size()))) > 0)
+      received += n;
+    finish_time = highp_clock();
+  });
+
+  xxsocket source;
+  source.pconnect("127.0.0.1", RELAY_PORT);
+  while (!ready)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  std::vector<char> data(256 * 1024, 'x');
+  auto start = highp_clock();
+  for (long long sent = 0; sent < total_bytes;)
+  {
+    int n = source.send(data.data(), static_cast<int>((std::min)(static_cast<long long>(data.size()), total_bytes - sent)));
+    if (n <= 0)
+      break;
+    sent += n;
+  }
+  // half-close, the EOF propagated to sink in relay mode
+  source.shutdown(SD_SEND);
+  sink.join();
+
+  auto elapsed = (finish_time - start) / 1000.0;
+  printf("mode=%-5s transferred=%lld/%lld(MB), cost: %.3lf(ms), speed: %.1lf(MB/s)\n", kernel_relay ? "relay" : "copy", received >> 20, total_bytes >> 20, elapsed,
+         (received >> 20) * 1000.0 / elapsed);
+
+  source.close();
+  relay.stop();
+}
+
+// half-close: the source shutdown it's send side, the relay propagates the EOF to sink and keeps the other
+// direction alive, the io loop must go idle instead of being waked by the readable EOF of source forever
+static bool run_half_close()
+{
+  io_hostent endpoints[] = {{"127.0.0.1", RELAY_PORT}, {"127.0.0.1", SINK_PORT}};
+  io_service relay(endpoints, 2);
+  relay.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+
+  transport_handle_t client = nullptr;
+  std::atomic<bool> ready{false};
+  relay.start([&](event_ptr&& ev) {
+    if (ev->kind() != YEK_ON_OPEN || ev->status() != 0)
+      return;
+    if (ev->cindex() == 0)
+    {
+      client = ev->transport();
+      relay.open(1, YCK_TCP_CLIENT);
+    }
+    else
+    {
+      relay.relay(client, ev->transport());
+      ready = true;
+    }
+  });
+
+  xxsocket listener;
+  listener.pserve(ip::endpoint("127.0.0.1", SINK_PORT));
+  relay.open(0, YCK_TCP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+  xxsocket source;
+  source.pconnect("127.0.0.1", RELAY_PORT);
+  auto sink = listener.accept();
+  while (!ready)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  source.send("hello", 5);
+  source.shutdown(SD_SEND);
+  char buf[64];
+  int received = 0, n;
+  while ((n = sink.recv(buf, sizeof(buf))) > 0)
+    received += n;
+
+  // only the io thread runs now, the cpu time it costs while the pair half-closed
+  auto cpu_start = std::clock();
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  double cpu_ms = (std::clock() - cpu_start) * 1000.0 / CLOCKS_PER_SEC;
+
+  // the other direction still works
+  sink.send("bye", 3);
+  int echoed = source.recv(buf, sizeof(buf));
+
+  bool ok = received == 5 && n == 0 && echoed == 3 && cpu_ms < 100;
+  printf("mode=half-close received=%d, echoed=%d, cpu: %.3lf(ms) %s\n", received, echoed, cpu_ms, ok ? "OK" : "FAILED");
+
+  source.close();
+  sink.close();
+  relay.stop();
+  return ok;
+}
+} // namespace relaytest
+
+int main(int argc, char** argv)
+{
+  long long total_bytes = (argc > 1 ? atoll(argv[1]) : 1024) << 20;
+
+  relaytest::run(false, total_bytes);
+  relaytest::run(true, total_bytes);
+
+  return relaytest::run_half_close() ? 0 : 1;
+}
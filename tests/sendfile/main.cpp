@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#if defined(_WIN32)
+#  include <io.h>
+#  include <fcntl.h>
+#else
+#  include <unistd.h>
+#endif
+
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+
+/*
+io_service::write_file test: client --> sink
+  - regular file: the range [offset, end of file) sent in order with the write ops queued before and after it
+  - non-regular file: i.e. pipe, refused, because read it may block the io thread
+*/
+
+namespace sendfiletest
+{
+enum
+{
+  SINK_PORT = 30005,
+};
+
+static const char* FILE_NAME = "sendfile_test.bin";
+static const int FILE_SIZE   = 1024 * 1024 + 123;
+static const int FILE_OFFSET = 100;
+
+static bool run()
+{
+  std::vector<char> content(FILE_SIZE);
+  for (int i = 0; i < FILE_SIZE; ++i)
+    content[i] = static_cast<char>(i * 31 + i / 256);
+  FILE* fp = fopen(FILE_NAME, "wb");
+  if (!fp)
+  {
+    printf("create %s failed\n", FILE_NAME);
+    return false;
+  }
+  fwrite(content.data(), 1, content.size(), fp);
+  fclose(fp);
+
+  io_hostent endpoints[] = {{"127.0.0.1", SINK_PORT}};
+  io_service client(endpoints, 1);
+
+  transport_handle_t transport = nullptr;
+  std::atomic<bool> ready{false};
+  client.start([&](event_ptr&& ev) {
+    if (ev->kind() == YEK_ON_OPEN && ev->status() == 0)
+    {
+      transport = ev->transport();
+      ready     = true;
+    }
+  });
+
+  xxsocket listener;
+  listener.pserve(ip::endpoint("127.0.0.1", SINK_PORT));
+  client.open(0, YCK_TCP_CLIENT);
+  auto sink = listener.accept();
+  while (!ready)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  // the non-regular file refused
+  int pipe_ret = 0;
+  int fds[2];
+#if defined(_WIN32)
+  if (::_pipe(fds, 4096, _O_BINARY) == 0)
+  {
+    pipe_ret = client.write_file(transport, fds[0]);
+    ::_close(fds[0]);
+    ::_close(fds[1]);
+  }
+#else
+  if (::pipe(fds) == 0)
+  {
+    pipe_ret = client.write_file(transport, fds[0]);
+    ::close(fds[0]);
+    ::close(fds[1]);
+  }
+#endif
+
+  // the regular file sent between the write ops
+  std::atomic<int> file_status{1};
+  client.write(transport, "head", 4);
+  int file_ret = client.write_file(transport, FILE_NAME, FILE_OFFSET, 0, [&](int ec, size_t) { file_status = ec; });
+  client.write(transport, "tail", 4);
+
+  const int expected_size = 4 + FILE_SIZE - FILE_OFFSET + 4;
+  std::vector<char> received;
+  std::vector<char> buf(64 * 1024);
+  int n;
+  while (static_cast<int>(received.size()) < expected_size && (n = sink.recv(buf.data(), static_cast<int>(buf.size()))) > 0)
+    received.insert(received.end(), buf.data(), buf.data() + n);
+  for (int i = 0; i < 100 && file_status == 1; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  bool ok = pipe_ret < 0 && file_ret == 0 && file_status == 0 && static_cast<int>(received.size()) == expected_size &&
+            memcmp(received.data(), "head", 4) == 0 && memcmp(received.data() + 4, content.data() + FILE_OFFSET, FILE_SIZE - FILE_OFFSET) == 0 &&
+            memcmp(received.data() + expected_size - 4, "tail", 4) == 0;
+  printf("pipe=%d, file=%d, status=%d, received=%d/%d %s\n", pipe_ret, file_ret, file_status.load(), static_cast<int>(received.size()), expected_size,
+         ok ? "OK" : "FAILED");
+
+  sink.close();
+  client.stop();
+  remove(FILE_NAME);
+  return ok;
+}
+} // namespace sendfiletest
+
+int main()
+{
+  return sendfiletest::run() ? 0 : 1;
+}
@@ -298,6 +298,116 @@ void start_receiver(io_service& service)
   service.open(0, speedtest::RECEIVER_CHANNEL_KIND);
 }
 
+#if YASIO__HAS_MMSG
+// UDP small datagrams packet rate with different YOPT_S_UDP_BATCH, usage: speedtest batch
+static void run_udp_batch(int batch_size)
+{
+  enum
+  {
+    BATCH_PORT        = 30003,
+    BATCH_PACKET_SIZE = 512,
+    BATCH_INFLIGHT    = 256,
+  };
+  static char buffer[BATCH_PACKET_SIZE];
+  io_hostent receiver_ep("127.0.0.1", BATCH_PORT), sender_ep("127.0.0.1", BATCH_PORT);
+  io_service receiver(&receiver_ep, 1), sender(&sender_ep, 1);
+  receiver.set_option(YOPT_S_UDP_BATCH, batch_size);
+  receiver.set_option(YOPT_S_FORWARD_PACKET, 1);
+  receiver.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+  sender.set_option(YOPT_S_UDP_BATCH, batch_size);
+
+  std::atomic<long long> recv_packets{0};
+  receiver.start([&](event_ptr event) {
+    if (event->kind() == YEK_PACKET)
+      ++recv_packets;
+  });
+  receiver.open(0, YCK_UDP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  std::atomic<bool> stopped{false};
+  long long send_packets = 0;
+  std::function<void(transport_handle_t)> send_one = [&](transport_handle_t thandle) {
+    sender.forward(thandle, buffer, sizeof(buffer), [&, thandle](int ec, size_t) {
+      ++send_packets;
+      if (!ec && !stopped)
+        send_one(thandle);
+    });
+  };
+  sender.start([&](event_ptr event) {
+    if (event->kind() == YEK_CONNECT_RESPONSE && event->status() == 0)
+      for (int i = 0; i < BATCH_INFLIGHT; ++i)
+        send_one(event->transport());
+  });
+  sender.open(0, YCK_UDP_CLIENT);
+
+  auto time_start = yasio::highp_clock<>();
+  std::this_thread::sleep_for(std::chrono::seconds(3));
+  stopped = true;
+  auto time_elapsed = (yasio::highp_clock<>() - time_start) / 1000000.0;
+  long long received = recv_packets;
+  sender.stop();
+  receiver.stop();
+  printf("UDP batch=%-2d send: %.0lf(pps), recv: %.0lf(pps)\n", batch_size, send_packets / time_elapsed, received / time_elapsed);
+}
+#endif
+
+#if YASIO__HAS_ZEROCOPY
+// TCP large payloads throughput with and without YOPT_C_ZEROCOPY, usage: speedtest zerocopy
+// !Note: the loopback device always copy data, so test between two hosts for the real zero-copy
+static void run_tcp_zerocopy(int threshold)
+{
+  enum
+  {
+    ZEROCOPY_PORT         = 30004,
+    ZEROCOPY_PAYLOAD_SIZE = 4 * 1024 * 1024,
+    ZEROCOPY_INFLIGHT     = 4,
+  };
+  static std::vector<char> payload(ZEROCOPY_PAYLOAD_SIZE, 'z');
+  io_hostent receiver_ep("127.0.0.1", ZEROCOPY_PORT), sender_ep("127.0.0.1", ZEROCOPY_PORT);
+  io_service receiver(&receiver_ep, 1), sender(&sender_ep, 1);
+  receiver.set_option(YOPT_S_FORWARD_PACKET, 1);
+  receiver.set_option(YOPT_C_MOD_FLAGS, 0, YCF_REUSEADDR, 0);
+  sender.set_option(YOPT_C_ZEROCOPY, 0, threshold);
+
+  std::atomic<long long> recv_bytes{0};
+  receiver.start([&](event_ptr event) {
+    if (event->kind() == YEK_PACKET)
+      recv_bytes += event->packet_view().size();
+  });
+  receiver.open(0, YCK_TCP_SERVER);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  std::atomic<bool> stopped{false};
+  long long send_bytes = 0;
+  std::function<void(transport_handle_t)> send_one = [&](transport_handle_t thandle) {
+    sender.forward(thandle, payload.data(), payload.size(), [&, thandle](int ec, size_t bytes_transferred) {
+      send_bytes += bytes_transferred;
+      if (!ec && !stopped)
+        send_one(thandle);
+    });
+  };
+  sender.start([&](event_ptr event) {
+    if (event->kind() == YEK_CONNECT_RESPONSE && event->status() == 0)
+      for (int i = 0; i < ZEROCOPY_INFLIGHT; ++i)
+        send_one(event->transport());
+  });
+  sender.open(0, YCK_TCP_CLIENT);
+
+  auto time_start = yasio::highp_clock<>();
+  std::this_thread::sleep_for(std::chrono::seconds(3));
+  stopped           = true;
+  auto time_elapsed = (yasio::highp_clock<>() - time_start) / 1000000.0;
+  double received   = static_cast<double>(recv_bytes);
+  sender.stop();
+  receiver.stop();
+
+  char str_send_speed[128], str_recv_speed[128];
+  sbtoa(send_bytes / time_elapsed, str_send_speed, sizeof(str_send_speed));
+  sbtoa(received / time_elapsed, str_recv_speed, sizeof(str_recv_speed));
+  printf("TCP zerocopy threshold=%-7d send: %s/s, recv: %s/s\n", threshold, str_send_speed, str_recv_speed);
+}
+#endif
+
 int main(int argc, char** argv)
 {
   io_hostent receiver_ep(SPEEDTEST_LISTEN_NAME, speedtest::RECEIVER_PORT), sender_ep(SPEEDTEST_SOCKET_NAME, speedtest::SENDER_PORT);
@@ -307,6 +417,24 @@ int main(int argc, char** argv)
   if (argc > 1)
     mode = argv[1];
 
+#if YASIO__HAS_MMSG
+  if (cxx20::ic::iequals(mode, "batch"))
+  {
+    for (auto batch_size : {1, 8, 32})
+      run_udp_batch(batch_size);
+    return 0;
+  }
+#endif
+
+#if YASIO__HAS_ZEROCOPY
+  if (cxx20::ic::iequals(mode, "zerocopy"))
+  {
+    for (auto threshold : {0, 64 * 1024})
+      run_tcp_zerocopy(threshold);
+    return 0;
+  }
+#endif
+
   if (cxx20::ic::iequals(mode, "server"))
     start_receiver(receiver);
   else if (cxx20::ic::iequals(mode, "client"))
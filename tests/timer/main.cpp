@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+
+/*
+Timer micro benchmark, simulate one read-timeout or heartbeat timer per connection, the cost of each stage
+includes the time io thread applied the posted operations:
+  - schedule: schedule all timers with random expire time
+  - reschedule: reset all timers with new expire time, i.e. the read-timeout reset when packet received
+  - cancel: cancel all timers
+  - fire: schedule all timers expire in 100ms, and wait all of them fired
+usage: timertest [timers]
+*/
+
+namespace timertest
+{
+// wait the operations posted before applied by io thread, the inbox is FIFO for one producer
+static void sync(io_service& service)
+{
+  std::atomic<bool> applied{false};
+  highp_timer marker(service);
+  marker.expires_from_now(std::chrono::microseconds(0));
+  marker.async_wait_once([&](io_service&) { applied = true; });
+  while (!applied)
+    std::this_thread::yield();
+}
+
+static void report(const char* stage, int timers, highp_time_t start)
+{
+  auto elapsed = (highp_clock() - start) / 1000.0;
+  printf("stage=%-10s timers=%d, cost: %.3lf(ms), rate: %.1lf(ops/ms)\n", stage, timers, elapsed, timers / elapsed);
+}
+
+static void run(int count)
+{
+  io_service service;
+  service.start([](event_ptr&&) {});
+
+  std::vector<std::unique_ptr<highp_timer>> timers;
+  timers.reserve(count);
+  for (int i = 0; i < count; ++i)
+    timers.emplace_back(new highp_timer(service));
+
+  std::mt19937 rng(count);
+  std::uniform_int_distribution<int> timeout_ms(10000, 60000);
+  auto wait_forever = [](io_service&) { return true; };
+
+  auto start = highp_clock();
+  for (auto& timer : timers)
+  {
+    timer->expires_from_now(std::chrono::milliseconds(timeout_ms(rng)));
+    timer->async_wait(wait_forever);
+  }
+  sync(service);
+  report("schedule", count, start);
+
+  start = highp_clock();
+  for (auto& timer : timers)
+  {
+    timer->expires_from_now(std::chrono::milliseconds(timeout_ms(rng)));
+    timer->async_wait(wait_forever);
+  }
+  sync(service);
+  report("reschedule", count, start);
+
+  start = highp_clock();
+  for (auto& timer : timers)
+    timer->cancel();
+  sync(service);
+  report("cancel", count, start);
+
+  std::atomic<int> fired{0};
+  std::uniform_int_distribution<int> expire_us(0, 100000);
+  start = highp_clock();
+  for (auto& timer : timers)
+  {
+    timer->expires_from_now(std::chrono::microseconds(expire_us(rng)));
+    timer->async_wait_once([&](io_service&) { ++fired; });
+  }
+  auto deadline = start + std::chrono::microseconds(std::chrono::seconds(30)).count();
+  while (fired < count && highp_clock() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  printf("fired=%d/%d\n", (int)fired, count);
+  report("fire", count, start);
+
+  service.stop();
+}
+} // namespace timertest
+
+int main(int argc, char** argv)
+{
+  int timers = argc > 1 ? atoi(argv[1]) : 100000;
+
+  timertest::run(timers);
+
+  return 0;
+}
@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "yasio/yasio.hpp"
+
+using namespace yasio;
+
+/*
+Multi-producer write benchmark, lots of threads write small packets to one tcp transport:
+  - write: the cost of io_service::write at producer threads, i.e. the send queue contention
+  - deliver: the time until all bytes received by peer
+usage: writetest [producers] [writes per producer] [packet size]
+Build the yasio library with different flags to compare the send queue implementations, one build dir per flag:
+  - default: the lock-free mpsc queue
+      cmake -S . -B build_mpsc -DCMAKE_BUILD_TYPE=Release && cmake --build build_mpsc --target writetest
+  - YASIO_USE_LOCKED_SEND_QUEUE: std's queue + mutex
+      cmake -S . -B build_locked -DCMAKE_BUILD_TYPE=Release -DYASIO_USE_LOCKED_SEND_QUEUE=ON && cmake --build build_locked --target writetest
+  - YASIO_USE_SPSC_QUEUE: the spsc queue, only one producer allowed
+      cmake -S . -B build_spsc -DCMAKE_BUILD_TYPE=Release -DYASIO_USE_SPSC_QUEUE=ON && cmake --build build_spsc --target writetest
+then run build_<name>/tests/write/writetest with the same args, i.e. 1, 4 and 8 producers,
+the queue contention only shows when the producers and io thread run on different cpu cores
+*/
+
+namespace writetest
+{
+enum
+{
+  SERVER_PORT = 30006,
+};
+
+static void run(int producers, int writes, int packet_size)
+{
+#if defined(YASIO_USE_SPSC_QUEUE)
+  if (producers > 1)
+  {
+    printf("the spsc queue only allow one producer, producers=%d -> 1\n", producers);
+    writes *= producers;
+    producers = 1;
+  }
+#endif
+  const long long total_bytes = static_cast<long long>(producers) * writes * packet_size;
+
+  xxsocket server;
+  if (server.pserve("127.0.0.1", SERVER_PORT) != 0)
+  {
+    printf("listen at port %d failed\n", SERVER_PORT);
+    return;
+  }
+  std::atomic<long long> received{0};
+  std::thread receiver([&] {
+    auto peer = server.accept();
+    std::vector<char> buf(65536);
+    while (received < total_bytes)
+    {
+      int n = peer.recv(buf.data(), static_cast<int>(buf.size()));
+      if (n <= 0)
+        break;
+      received += n;
+    }
+  });
+
+  io_hostent endpoint{"127.0.0.1", SERVER_PORT};
+  io_service client(&endpoint, 1);
+  std::atomic<transport_handle_t> transport{nullptr};
+  client.start([&](event_ptr&& ev) {
+    if (ev->kind() == YEK_ON_OPEN && ev->status() == 0)
+      transport = ev->transport();
+  });
+  client.open(0, YCK_TCP_CLIENT);
+  auto deadline = highp_clock() + std::chrono::microseconds(std::chrono::seconds(10)).count();
+  while (!transport && highp_clock() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  if (!transport)
+  {
+    printf("connect timeout\n");
+    server.close();
+    receiver.join();
+    return;
+  }
+
+  std::atomic<long long> write_cost{0};
+  std::vector<std::thread> threads;
+  auto start = highp_clock();
+  for (int i = 0; i < producers; ++i)
+  {
+    threads.emplace_back([&] {
+      std::vector<char> packet(packet_size, 'x');
+      transport_handle_t thandle = transport;
+      auto thread_start          = highp_clock();
+      for (int k = 0; k < writes; ++k)
+        client.write(thandle, packet.data(), packet.size());
+      write_cost += highp_clock() - thread_start;
+    });
+  }
+  for (auto& t : threads)
+    t.join();
+  auto write_elapsed = (highp_clock() - start) / 1000.0;
+
+  deadline = highp_clock() + std::chrono::microseconds(std::chrono::seconds(60)).count();
+  while (received < total_bytes && highp_clock() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  auto deliver_elapsed = (highp_clock() - start) / 1000.0;
+
+  const int total_writes = producers * writes;
+  printf("producers=%d writes=%d packet=%d, write: %.3lf(ms), %.1lf(ns/write per producer)\n", producers, total_writes, packet_size, write_elapsed,
+         write_cost * 1000.0 / total_writes);
+  printf("received=%lld/%lld, deliver: %.3lf(ms), rate: %.1lf(writes/ms)\n", (long long)received, total_bytes, deliver_elapsed,
+         total_writes / deliver_elapsed);
+
+  client.stop();
+  server.close();
+  receiver.join();
+}
+} // namespace writetest
+
+int main(int argc, char** argv)
+{
+  int producers   = argc > 1 ? atoi(argv[1]) : 4;
+  int writes      = argc > 2 ? atoi(argv[2]) : 100000;
+  int packet_size = argc > 3 ? atoi(argv[3]) : 64;
+
+  writetest::run(producers, writes, packet_size);
+
+  return 0;
+}
@@ -217,11 +217,13 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
           case YOPT_C_REMOTE_HOST:
             service->set_option(opt, static_cast<int>(args[0]), args[1].as<const char*>());
             break;
+          case YOPT_S_IO_LOOPS:
           case YOPT_C_UNPACK_STRIP:
           case YOPT_C_LOCAL_PORT:
           case YOPT_C_REMOTE_PORT:
           case YOPT_C_KCP_CONV:
           case YOPT_C_UNPACK_NO_BSWAP:
+          case YOPT_C_ZEROCOPY:
             service->set_option(opt, static_cast<int>(args[0]), static_cast<int>(args[1]));
             break;
           case YOPT_C_ENABLE_MCAST:
@@ -229,7 +231,10 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
           case YOPT_C_REMOTE_ENDPOINT:
             service->set_option(opt, static_cast<int>(args[0]), args[1].as<const char*>(), static_cast<int>(args[2]));
             break;
+          case YOPT_S_EVENT_WATERMARKS:
+          case YOPT_C_SEND_WATERMARKS:
           case YOPT_C_MOD_FLAGS:
+          case YOPT_C_ACCEPT_PARAMS:
             service->set_option(opt, static_cast<int>(args[0]), static_cast<int>(args[1]), static_cast<int>(args[2]));
             break;
           case YOPT_S_TCP_KEEPALIVE:
@@ -247,6 +252,19 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
               service->set_option(opt, std::addressof(fnwrap));
             }
             break;
+          case YOPT_S_BATCH_EVENT_CB:
+            (void)0;
+            {
+              sol::function fn        = args[0];
+              batch_event_cb_t fnwrap = [=](event_ptr* events, size_t count) mutable -> void {
+                sol::table batch = sol::state_view(fn.lua_state()).create_table(static_cast<int>(count), 0);
+                for (size_t i = 0; i < count; ++i)
+                  batch.raw_set(i + 1, std::move(events[i]));
+                fn(batch);
+              };
+              service->set_option(opt, std::addressof(fnwrap));
+            }
+            break;
           default:
             service->set_option(opt, static_cast<int>(args[0]));
         }
@@ -256,6 +274,7 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
                     static_cast<bool (io_service::*)(transport_handle_t) const>(&io_service::is_open)),
       "close",
       sol::overload(static_cast<void (io_service::*)(transport_handle_t)>(&io_service::close), static_cast<void (io_service::*)(int)>(&io_service::close)),
+      "pause_read", &io_service::pause_read, "resume_read", &io_service::resume_read,
       "write",
       sol::overload(
           [](io_service* service, transport_handle_t transport, cxx17::string_view s) {
@@ -270,6 +289,17 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
           [](io_service* service, transport_handle_t transport, yasio::obstream* obs, cxx17::string_view ip, u_short port) {
             return service->write_to(transport, std::move(obs->buffer()), ip::endpoint{ip.data(), port});
           }),
+      "broadcast",
+      [](io_service* service, sol::table transports, cxx17::string_view s) {
+        std::vector<transport_handle_t> thandles;
+        for (auto item : transports)
+          thandles.push_back(item.second.as<transport_handle_t>());
+        return service->broadcast(thandles, std::make_shared<const yasio::sbyte_buffer>(s.data(), s.data() + s.length()));
+      },
+      "join_group", &io_service::join_group, "leave_group", &io_service::leave_group, "publish",
+      [](io_service* service, cxx17::string_view group, cxx17::string_view s) {
+        service->publish(group, std::make_shared<const yasio::sbyte_buffer>(s.data(), s.data() + s.length()));
+      },
       "native_ptr", [](io_service* service) { return (void*)service; });
 
   // ##-- obstream
@@ -316,6 +346,10 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
   YASIO_EXPORT_ANY(YOPT_S_DNS_QUERIES_TIMEOUT);
   YASIO_EXPORT_ANY(YOPT_S_TCP_KEEPALIVE);
   YASIO_EXPORT_ANY(YOPT_S_EVENT_CB);
+  YASIO_EXPORT_ANY(YOPT_S_BATCH_EVENT_CB);
+  YASIO_EXPORT_ANY(YOPT_S_EVENT_WATERMARKS);
+  YASIO_EXPORT_ANY(YOPT_S_IO_LOOPS);
+  YASIO_EXPORT_ANY(YOPT_S_UDP_BATCH);
   YASIO_EXPORT_ANY(YOPT_C_UNPACK_PARAMS);
   YASIO_EXPORT_ANY(YOPT_C_UNPACK_STRIP);
   YASIO_EXPORT_ANY(YOPT_C_UNPACK_NO_BSWAP);
@@ -336,13 +370,24 @@ YASIO_LUA_API int luaopen_yasio(lua_State* L)
   YASIO_EXPORT_ANY(YOPT_C_KCP_RTO_MIN);
 #  endif
   YASIO_EXPORT_ANY(YOPT_C_MOD_FLAGS);
+  YASIO_EXPORT_ANY(YOPT_C_ACCEPT_PARAMS);
+  YASIO_EXPORT_ANY(YOPT_C_ZEROCOPY);
+  YASIO_EXPORT_ANY(YOPT_C_SEND_WATERMARKS);
 
   YASIO_EXPORT_ANY(YCF_REUSEADDR);
   YASIO_EXPORT_ANY(YCF_EXCLUSIVEADDRUSE);
+  YASIO_EXPORT_ANY(YCF_REUSEPORT_LB);
+  YASIO_EXPORT_ANY(YCF_REUSEPORT_CBPF);
+  YASIO_EXPORT_ANY(YCF_UDP_GSO);
+  YASIO_EXPORT_ANY(YCF_UDP_GRO);
+  YASIO_EXPORT_ANY(YLB_ROUND_ROBIN);
+  YASIO_EXPORT_ANY(YLB_LEAST_LOADED);
 
   YASIO_EXPORT_ANY(YEK_ON_OPEN);
   YASIO_EXPORT_ANY(YEK_ON_CLOSE);
   YASIO_EXPORT_ANY(YEK_ON_PACKET);
+  YASIO_EXPORT_ANY(YEK_ON_SEND_HIGH);
+  YASIO_EXPORT_ANY(YEK_ON_SEND_LOW);
   YASIO_EXPORT_ANY(YEK_CONNECT_RESPONSE);
   YASIO_EXPORT_ANY(YEK_CONNECTION_LOST);
   YASIO_EXPORT_ANY(YEK_PACKET);
@@ -650,6 +695,8 @@ end
                                   static_cast<bool (io_service::*)(transport_handle_t) const>(&io_service::is_open))
           .addOverloadedFunctions("close", static_cast<void (io_service::*)(transport_handle_t)>(&io_service::close),
                                   static_cast<void (io_service::*)(int)>(&io_service::close))
+          .addFunction("pause_read", &io_service::pause_read)
+          .addFunction("resume_read", &io_service::resume_read)
           .addOverloadedFunctions(
               "write",
               [](io_service* service, transport_handle_t transport, cxx17::string_view s) {
@@ -664,6 +711,18 @@ end
               [](io_service* service, transport_handle_t transport, yasio::obstream* obs, cxx17::string_view ip, u_short port) {
                 return service->write_to(transport, std::move(obs->buffer()), ip::endpoint{ip.data(), port});
               })
+          .addStaticFunction("broadcast",
+                             [](io_service* service, kaguya::LuaTable transports, cxx17::string_view s) {
+                               std::vector<transport_handle_t> thandles;
+                               transports.foreach_table<int, transport_handle_t>([&](int, transport_handle_t thandle) { thandles.push_back(thandle); });
+                               return service->broadcast(thandles, std::make_shared<const yasio::sbyte_buffer>(s.data(), s.data() + s.length()));
+                             })
+          .addFunction("join_group", &io_service::join_group)
+          .addFunction("leave_group", &io_service::leave_group)
+          .addStaticFunction("publish",
+                             [](io_service* service, cxx17::string_view group, cxx17::string_view s) {
+                               service->publish(group, std::make_shared<const yasio::sbyte_buffer>(s.data(), s.data() + s.length()));
+                             })
           .addStaticFunction("set_option",
                              [](io_service* service, int opt, kaguya::VariadicArgType args) {
                                switch (opt)
@@ -673,11 +732,13 @@ end
                                    service->set_option(opt, static_cast<int>(args[0]), static_cast<const char*>(args[1]));
                                    break;
 
+                                 case YOPT_S_IO_LOOPS:
                                  case YOPT_C_UNPACK_STRIP:
                                  case YOPT_C_LOCAL_PORT:
                                  case YOPT_C_REMOTE_PORT:
                                  case YOPT_C_KCP_CONV:
                                  case YOPT_C_UNPACK_NO_BSWAP:
+                                 case YOPT_C_ZEROCOPY:
                                    service->set_option(opt, static_cast<int>(args[0]), static_cast<int>(args[1]));
                                    break;
                                  case YOPT_C_ENABLE_MCAST:
@@ -685,7 +746,10 @@ end
                                  case YOPT_C_REMOTE_ENDPOINT:
                                    service->set_option(opt, static_cast<int>(args[0]), static_cast<const char*>(args[1]), static_cast<int>(args[2]));
                                    break;
+                                 case YOPT_S_EVENT_WATERMARKS:
+                                 case YOPT_C_SEND_WATERMARKS:
                                  case YOPT_C_MOD_FLAGS:
+                                 case YOPT_C_ACCEPT_PARAMS:
                                    service->set_option(opt, static_cast<int>(args[0]), static_cast<int>(args[1]), static_cast<int>(args[2]));
                                    break;
                                  case YOPT_S_TCP_KEEPALIVE:
@@ -703,6 +767,19 @@ end
                                      service->set_option(opt, std::addressof(fnwrap));
                                    }
                                    break;
+                                 case YOPT_S_BATCH_EVENT_CB:
+                                   (void)0;
+                                   {
+                                     kaguya::LuaFunction fn  = args[0];
+                                     batch_event_cb_t fnwrap = [=](event_ptr* events, size_t count) mutable -> void {
+                                       kaguya::LuaTable batch(fn.state(), kaguya::NewTable(static_cast<int>(count), 0));
+                                       for (size_t i = 0; i < count; ++i)
+                                         batch.setRawField(static_cast<int>(i + 1), events[i].get());
+                                       fn(batch);
+                                     };
+                                     service->set_option(opt, std::addressof(fnwrap));
+                                   }
+                                   break;
                                  default:
                                    service->set_option(opt, static_cast<int>(args[0]));
                                }
@@ -759,6 +836,10 @@ end
   YASIO_EXPORT_ANY(YOPT_S_DNS_QUERIES_TIMEOUT);
   YASIO_EXPORT_ANY(YOPT_S_TCP_KEEPALIVE);
   YASIO_EXPORT_ANY(YOPT_S_EVENT_CB);
+  YASIO_EXPORT_ANY(YOPT_S_BATCH_EVENT_CB);
+  YASIO_EXPORT_ANY(YOPT_S_EVENT_WATERMARKS);
+  YASIO_EXPORT_ANY(YOPT_S_IO_LOOPS);
+  YASIO_EXPORT_ANY(YOPT_S_UDP_BATCH);
   YASIO_EXPORT_ANY(YOPT_C_UNPACK_PARAMS);
   YASIO_EXPORT_ANY(YOPT_C_UNPACK_STRIP);
   YASIO_EXPORT_ANY(YOPT_C_UNPACK_NO_BSWAP);
@@ -773,13 +854,24 @@ end
   YASIO_EXPORT_ANY(YOPT_C_DISABLE_MCAST);
   YASIO_EXPORT_ANY(YOPT_C_KCP_CONV);
   YASIO_EXPORT_ANY(YOPT_C_MOD_FLAGS);
+  YASIO_EXPORT_ANY(YOPT_C_ACCEPT_PARAMS);
+  YASIO_EXPORT_ANY(YOPT_C_ZEROCOPY);
+  YASIO_EXPORT_ANY(YOPT_C_SEND_WATERMARKS);
 
   YASIO_EXPORT_ANY(YCF_REUSEADDR);
   YASIO_EXPORT_ANY(YCF_EXCLUSIVEADDRUSE);
+  YASIO_EXPORT_ANY(YCF_REUSEPORT_LB);
+  YASIO_EXPORT_ANY(YCF_REUSEPORT_CBPF);
+  YASIO_EXPORT_ANY(YCF_UDP_GSO);
+  YASIO_EXPORT_ANY(YCF_UDP_GRO);
+  YASIO_EXPORT_ANY(YLB_ROUND_ROBIN);
+  YASIO_EXPORT_ANY(YLB_LEAST_LOADED);
 
   YASIO_EXPORT_ANY(YEK_ON_OPEN);
   YASIO_EXPORT_ANY(YEK_ON_CLOSE);
   YASIO_EXPORT_ANY(YEK_ON_PACKET);
+  YASIO_EXPORT_ANY(YEK_ON_SEND_HIGH);
+  YASIO_EXPORT_ANY(YEK_ON_SEND_LOW);
   YASIO_EXPORT_ANY(YEK_CONNECT_RESPONSE);
   YASIO_EXPORT_ANY(YEK_CONNECTION_LOST);
   YASIO_EXPORT_ANY(YEK_PACKET);
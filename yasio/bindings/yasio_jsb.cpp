@@ -1603,6 +1603,28 @@ bool js_yasio_io_service_close(JSContext* ctx, uint32_t argc, jsval* vp)
   return false;
 }
 
+template <void (io_service::*_Fn)(transport_handle_t)>
+bool js_yasio_io_service_transport_op(JSContext* ctx, uint32_t argc, jsval* vp)
+{
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  JS::RootedObject obj(ctx);
+  obj.set(args.thisv().toObjectOrNull());
+  js_proxy_t* proxy = jsb_get_js_proxy(obj);
+  auto cobj         = (io_service*)(proxy ? proxy->ptr : nullptr);
+  JSB_PRECONDITION2(cobj, ctx, false, "js_yasio_io_service_transport_op : Invalid Native Object");
+
+  if (argc == 1 && args.get(0).isObject())
+  {
+    auto transport = jsb_yasio_jsval_to_io_transport(ctx, args.get(0));
+    if (transport != nullptr)
+      (cobj->*_Fn)(transport);
+    return true;
+  }
+
+  JS_ReportError(ctx, "js_yasio_io_service_transport_op : wrong number of arguments");
+  return false;
+}
+
 bool js_yasio_io_service_dispatch(JSContext* ctx, uint32_t argc, jsval* vp)
 {
   bool ok          = true;
@@ -1661,6 +1683,7 @@ bool js_yasio_io_service_set_option(JSContext* ctx, uint32_t argc, jsval* vp)
 #endif
         case YOPT_C_LOCAL_PORT:
         case YOPT_C_REMOTE_PORT:
+        case YOPT_C_ZEROCOPY:
           service->set_option(opt, args[1].toInt32(), args[2].toInt32());
           break;
         case YOPT_C_ENABLE_MCAST:
@@ -1672,7 +1695,10 @@ bool js_yasio_io_service_set_option(JSContext* ctx, uint32_t argc, jsval* vp)
             service->set_option(opt, args[1].toInt32(), str.get(), args[3].toInt32());
           }
           break;
+        case YOPT_S_EVENT_WATERMARKS:
+        case YOPT_C_SEND_WATERMARKS:
         case YOPT_C_MOD_FLAGS:
+        case YOPT_C_ACCEPT_PARAMS:
           service->set_option(opt, args[1].toInt32(), args[2].toInt32(), args[3].toInt32());
           break;
         case YOPT_S_TCP_KEEPALIVE:
@@ -1697,6 +1723,28 @@ bool js_yasio_io_service_set_option(JSContext* ctx, uint32_t argc, jsval* vp)
           service->set_option(opt, std::addressof(callback));
           break;
         }
+        case YOPT_S_BATCH_EVENT_CB: {
+          JS::RootedObject jstarget(ctx, args.thisv().toObjectOrNull());
+          auto func                 = std::make_shared<JSFunctionWrapper>(ctx, jstarget, args[1], args.thisv());
+          batch_event_cb_t callback = [=](inet::event_ptr* events, size_t count) {
+            JSB_AUTOCOMPARTMENT_WITH_GLOBAL_OBJCET
+            JS::RootedObject jsevents(ctx, JS_NewArrayObject(ctx, count));
+            for (size_t i = 0; i < count; ++i)
+            {
+              JS::RootedValue jevent(ctx, jsb_yasio_to_jsval(ctx, std::move(events[i])));
+              JS_SetElement(ctx, jsevents, static_cast<uint32_t>(i), jevent);
+            }
+            jsval jbatch = OBJECT_TO_JSVAL(jsevents);
+            JS::RootedValue rval(ctx);
+            bool succeed = func->invoke(1, &jbatch, &rval);
+            if (!succeed && JS_IsExceptionPending(ctx))
+            {
+              JS_ReportPendingException(ctx);
+            }
+          };
+          service->set_option(opt, std::addressof(callback));
+          break;
+        }
         case YOPT_C_KCP_CONV:
         case YOPT_C_KCP_MTU:
         case YOPT_C_KCP_RTO_MIN:
@@ -1841,6 +1889,8 @@ void js_register_yasio_io_service(JSContext* ctx, JS::HandleObject global)
                                    JS_FN("stop", js_yasio_io_service_stop, 2, JSPROP_PERMANENT | JSPROP_ENUMERATE),
                                    JS_FN("open", js_yasio_io_service_open, 2, JSPROP_PERMANENT | JSPROP_ENUMERATE),
                                    JS_FN("close", js_yasio_io_service_close, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE),
+                                   JS_FN("pause_read", js_yasio_io_service_transport_op<&io_service::pause_read>, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE),
+                                   JS_FN("resume_read", js_yasio_io_service_transport_op<&io_service::resume_read>, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE),
                                    JS_FN("is_open", js_yasio_io_service_is_open, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE),
                                    JS_FN("dispatch", js_yasio_io_service_dispatch, 1, JSPROP_PERMANENT | JSPROP_ENUMERATE),
                                    JS_FN("set_option", js_yasio_io_service_set_option, 2, JSPROP_PERMANENT | JSPROP_ENUMERATE),
@@ -1905,6 +1955,8 @@ void jsb_register_yasio(JSContext* ctx, JS::HandleObject global)
   YASIO_EXPORT_ENUM(YOPT_S_DNS_QUERIES_TIMEOUT);
   YASIO_EXPORT_ENUM(YOPT_S_TCP_KEEPALIVE);
   YASIO_EXPORT_ENUM(YOPT_S_EVENT_CB);
+  YASIO_EXPORT_ENUM(YOPT_S_BATCH_EVENT_CB);
+  YASIO_EXPORT_ENUM(YOPT_S_EVENT_WATERMARKS);
   YASIO_EXPORT_ENUM(YOPT_C_UNPACK_PARAMS);
   YASIO_EXPORT_ENUM(YOPT_C_LFBFD_PARAMS); // alias for YOPT_C_UNPACK_PARAMS
   YASIO_EXPORT_ENUM(YOPT_C_LOCAL_HOST);
@@ -1923,13 +1975,22 @@ void jsb_register_yasio(JSContext* ctx, JS::HandleObject global)
   YASIO_EXPORT_ENUM(YOPT_C_KCP_RTO_MIN);
 #endif
   YASIO_EXPORT_ENUM(YOPT_C_MOD_FLAGS);
+  YASIO_EXPORT_ENUM(YOPT_C_ACCEPT_PARAMS);
+  YASIO_EXPORT_ENUM(YOPT_C_ZEROCOPY);
+  YASIO_EXPORT_ENUM(YOPT_C_SEND_WATERMARKS);
 
   YASIO_EXPORT_ENUM(YCF_REUSEADDR);
   YASIO_EXPORT_ENUM(YCF_EXCLUSIVEADDRUSE);
+  YASIO_EXPORT_ENUM(YCF_REUSEPORT_LB);
+  YASIO_EXPORT_ENUM(YCF_REUSEPORT_CBPF);
+  YASIO_EXPORT_ENUM(YCF_UDP_GSO);
+  YASIO_EXPORT_ENUM(YCF_UDP_GRO);
 
   YASIO_EXPORT_ENUM(YEK_CONNECT_RESPONSE);
   YASIO_EXPORT_ENUM(YEK_CONNECTION_LOST);
   YASIO_EXPORT_ENUM(YEK_PACKET);
+  YASIO_EXPORT_ENUM(YEK_ON_SEND_HIGH);
+  YASIO_EXPORT_ENUM(YEK_ON_SEND_LOW);
 
   YASIO_EXPORT_ENUM(SEEK_CUR);
   YASIO_EXPORT_ENUM(SEEK_SET);
@@ -1299,6 +1299,30 @@ bool js_yasio_io_service_close(se::State& s)
 }
 SE_BIND_FUNC(js_yasio_io_service_close)
 
+static bool js_yasio_io_service_transport_op(se::State& s, void (io_service::*fn)(transport_handle_t))
+{
+  auto cobj = (io_service*)s.nativeThisObject();
+  SE_PRECONDITION2(cobj, false, ": Invalid Native Object");
+  const auto& args = s.args();
+  size_t argc      = args.size();
+
+  if (argc == 1 && args[0].isObject())
+  {
+    io_transport* transport = nullptr;
+    seval_to_native_ptr<io_transport*>(args[0], &transport);
+    if (transport != nullptr)
+      (cobj->*fn)(transport);
+    return true;
+  }
+
+  SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+  return false;
+}
+bool js_yasio_io_service_pause_read(se::State& s) { return js_yasio_io_service_transport_op(s, &io_service::pause_read); }
+SE_BIND_FUNC(js_yasio_io_service_pause_read)
+bool js_yasio_io_service_resume_read(se::State& s) { return js_yasio_io_service_transport_op(s, &io_service::resume_read); }
+SE_BIND_FUNC(js_yasio_io_service_resume_read)
+
 bool js_yasio_io_service_dispatch(se::State& s)
 {
   auto cobj = (io_service*)s.nativeThisObject();
@@ -1344,6 +1368,7 @@ bool js_yasio_io_service_set_option(se::State& s)
 #endif
         case YOPT_C_LOCAL_PORT:
         case YOPT_C_REMOTE_PORT:
+        case YOPT_C_ZEROCOPY:
           service->set_option(opt, args[1].toInt32(), args[2].toInt32());
           break;
         case YOPT_C_ENABLE_MCAST:
@@ -1351,7 +1376,10 @@ bool js_yasio_io_service_set_option(se::State& s)
         case YOPT_C_REMOTE_ENDPOINT:
           service->set_option(opt, args[1].toInt32(), args[2].toString().c_str(), args[3].toInt32());
           break;
+        case YOPT_S_EVENT_WATERMARKS:
+        case YOPT_C_SEND_WATERMARKS:
         case YOPT_C_MOD_FLAGS:
+        case YOPT_C_ACCEPT_PARAMS:
           service->set_option(opt, args[1].toInt32(), args[2].toInt32(), args[3].toInt32());
           break;
         case YOPT_S_TCP_KEEPALIVE:
@@ -1379,6 +1407,32 @@ bool js_yasio_io_service_set_option(se::State& s)
           service->set_option(opt, std::addressof(callback));
           break;
         }
+        case YOPT_S_BATCH_EVENT_CB: {
+          se::Value jsThis(s.thisObject());
+          se::Value jsFunc(args[1]);
+          jsThis.toObject()->attachObject(jsFunc.toObject());
+          batch_event_cb_t callback = [=](inet::event_ptr* events, size_t count) {
+            se::HandleObject jsevents(se::Object::createArrayObject(count));
+            for (size_t i = 0; i < count; ++i)
+            {
+              se::Value jevent;
+              native_ptr_to_seval<io_event>(events[i].release(), &jevent);
+              jsevents->setArrayElement(static_cast<uint32_t>(i), jevent);
+            }
+            se::ValueArray invokeArgs;
+            invokeArgs.resize(1);
+            invokeArgs[0].setObject(jsevents);
+            se::Object* thisObj = jsThis.isObject() ? jsThis.toObject() : nullptr;
+            se::Object* funcObj = jsFunc.toObject();
+            bool succeed        = funcObj->call(invokeArgs, thisObj);
+            if (!succeed)
+            {
+              se::ScriptEngine::getInstance()->clearException();
+            }
+          };
+          service->set_option(opt, std::addressof(callback));
+          break;
+        }
         case YOPT_C_KCP_CONV:
         case YOPT_C_KCP_MTU:
         case YOPT_C_KCP_RTO_MIN:
@@ -1496,6 +1550,8 @@ void js_register_yasio_io_service(se::Object* obj)
   DEFINE_IO_SERVICE_FUNC(stop);
   DEFINE_IO_SERVICE_FUNC(open);
   DEFINE_IO_SERVICE_FUNC(close);
+  DEFINE_IO_SERVICE_FUNC(pause_read);
+  DEFINE_IO_SERVICE_FUNC(resume_read);
   DEFINE_IO_SERVICE_FUNC(is_open);
   DEFINE_IO_SERVICE_FUNC(dispatch);
   DEFINE_IO_SERVICE_FUNC(write);
@@ -1563,6 +1619,8 @@ bool jsb_register_yasio(se::Object* obj)
   YASIO_EXPORT_ENUM(YOPT_S_DNS_QUERIES_TIMEOUT);
   YASIO_EXPORT_ENUM(YOPT_S_TCP_KEEPALIVE);
   YASIO_EXPORT_ENUM(YOPT_S_EVENT_CB);
+  YASIO_EXPORT_ENUM(YOPT_S_BATCH_EVENT_CB);
+  YASIO_EXPORT_ENUM(YOPT_S_EVENT_WATERMARKS);
   YASIO_EXPORT_ENUM(YOPT_C_UNPACK_PARAMS);
   YASIO_EXPORT_ENUM(YOPT_C_LFBFD_PARAMS); // alias for YOPT_C_UNPACK_PARAMS
   YASIO_EXPORT_ENUM(YOPT_C_LOCAL_HOST);
@@ -1581,9 +1639,16 @@ bool jsb_register_yasio(se::Object* obj)
   YASIO_EXPORT_ENUM(YOPT_C_KCP_RTO_MIN);
 #endif
   YASIO_EXPORT_ENUM(YOPT_C_MOD_FLAGS);
+  YASIO_EXPORT_ENUM(YOPT_C_ACCEPT_PARAMS);
+  YASIO_EXPORT_ENUM(YOPT_C_ZEROCOPY);
+  YASIO_EXPORT_ENUM(YOPT_C_SEND_WATERMARKS);
 
   YASIO_EXPORT_ENUM(YCF_REUSEADDR);
   YASIO_EXPORT_ENUM(YCF_EXCLUSIVEADDRUSE);
+  YASIO_EXPORT_ENUM(YCF_REUSEPORT_LB);
+  YASIO_EXPORT_ENUM(YCF_REUSEPORT_CBPF);
+  YASIO_EXPORT_ENUM(YCF_UDP_GSO);
+  YASIO_EXPORT_ENUM(YCF_UDP_GRO);
 
   YASIO_EXPORT_ENUM(YEK_CONNECT_RESPONSE);
   YASIO_EXPORT_ENUM(YEK_CONNECTION_LOST);
@@ -1592,6 +1657,8 @@ bool jsb_register_yasio(se::Object* obj)
   YASIO_EXPORT_ENUM(YEK_ON_OPEN);
   YASIO_EXPORT_ENUM(YEK_ON_CLOSE);
   YASIO_EXPORT_ENUM(YEK_ON_PACKET);
+  YASIO_EXPORT_ENUM(YEK_ON_SEND_HIGH);
+  YASIO_EXPORT_ENUM(YEK_ON_SEND_LOW);
 
   YASIO_EXPORT_ENUM(SEEK_CUR);
   YASIO_EXPORT_ENUM(SEEK_SET);
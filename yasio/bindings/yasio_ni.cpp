@@ -70,25 +70,53 @@ struct yasio_io_event {
   void* user;
 };
 
+static void yasio_ni_to_event(yasio_io_event& event, io_event* e, void* user)
+{
+  auto& pkt     = e->packet();
+  event.kind    = e->kind();
+  event.channel = e->cindex();
+  event.thandle = e->transport();
+  event.user    = user;
+  if (event.kind == yasio::YEK_ON_PACKET)
+    event.msg = !is_packet_empty(pkt) ? &pkt : nullptr;
+  else
+    event.status = e->status();
+}
+
 YASIO_NI_API void* yasio_create_service(int channel_count, void(YASIO_INTEROP_DECL* event_cb)(yasio_io_event* event), void* user)
 {
   assert(!!event_cb);
   io_service* service = new io_service(channel_count);
   service->start([=](event_ptr e) {
-    auto& pkt = e->packet();
     yasio_io_event event;
-    event.kind    = e->kind();
-    event.channel = e->cindex();
-    event.thandle = e->transport();
-    event.user    = user;
-    if (event.kind == yasio::YEK_ON_PACKET)
-      event.msg = !is_packet_empty(pkt) ? &pkt : nullptr;
-    else
-      event.status = e->status();
+    yasio_ni_to_event(event, e.get(), user);
     event_cb(&event);
   });
   return service;
 }
+/*
+  Sets the batch event callback, all events of one dispatch call passed at once, the
+  packet msg of events only valid until the callback returns
+  */
+YASIO_NI_API void yasio_set_batch_event_cb(void* service_ptr, void(YASIO_INTEROP_DECL* batch_cb)(yasio_io_event* events, int count), void* user)
+{
+  io_service* service = reinterpret_cast<io_service*>(service_ptr);
+  if (service)
+  {
+    batch_event_cb_t fn;
+    if (batch_cb)
+    {
+      auto ni_events = std::make_shared<std::vector<yasio_io_event>>();
+      fn             = [=](event_ptr* events, size_t count) {
+        ni_events->resize(count);
+        for (size_t i = 0; i < count; ++i)
+          yasio_ni_to_event((*ni_events)[i], events[i].get(), user);
+        batch_cb(ni_events->data(), static_cast<int>(count));
+      };
+    }
+    service->set_option(YOPT_S_BATCH_EVENT_CB, &fn);
+  }
+}
 YASIO_NI_API void* yasio_unwrap_ptr(void* opaque, int offset)
 {
   auto& pkt = *(packet_t*)opaque;
@@ -147,6 +175,8 @@ YASIO_NI_API void yasio_set_option(void* service_ptr, int opt, const char* pszAr
     case YOPT_S_DNS_CACHE_TIMEOUT:
     case YOPT_S_DNS_QUERIES_TIMEOUT:
     case YOPT_S_DNS_DIRTY:
+    case YOPT_S_READY_LIST:
+    case YOPT_S_UDP_BATCH:
     case YOPT_C_DISABLE_MCAST:
       service->set_option(opt, atoi(pszArgs));
       return;
@@ -172,10 +202,13 @@ YASIO_NI_API void yasio_set_option(void* service_ptr, int opt, const char* pszAr
     case YOPT_C_LOCAL_HOST:
       service->set_option(opt, svtoi(args[0]), svtoa(args[1]));
       break;
+    case YOPT_S_IO_LOOPS:
+    case YOPT_S_DISPATCH_THREADS:
     case YOPT_C_UNPACK_STRIP:
     case YOPT_C_LOCAL_PORT:
     case YOPT_C_REMOTE_PORT:
     case YOPT_C_UNPACK_NO_BSWAP:
+    case YOPT_C_ZEROCOPY:
       service->set_option(opt, svtoi(args[0]), svtoi(args[1]));
       break;
     case YOPT_C_ENABLE_MCAST:
@@ -183,7 +216,10 @@ YASIO_NI_API void yasio_set_option(void* service_ptr, int opt, const char* pszAr
     case YOPT_C_REMOTE_ENDPOINT:
       service->set_option(opt, svtoi(args[0]), svtoa(args[1]), svtoi(args[2]));
       break;
+    case YOPT_S_EVENT_WATERMARKS:
+    case YOPT_C_SEND_WATERMARKS:
     case YOPT_C_MOD_FLAGS:
+    case YOPT_C_ACCEPT_PARAMS:
       service->set_option(opt, svtoi(args[0]), svtoi(args[1]), svtoi(args[2]));
       break;
     case YOPT_S_TCP_KEEPALIVE:
@@ -225,6 +261,18 @@ YASIO_NI_API void yasio_close_handle(void* service_ptr, void* thandle)
   if (service)
     service->close(reinterpret_cast<transport_handle_t>(thandle));
 }
+YASIO_NI_API void yasio_pause_read(void* service_ptr, void* thandle)
+{
+  auto service = reinterpret_cast<io_service*>(service_ptr);
+  if (service)
+    service->pause_read(reinterpret_cast<transport_handle_t>(thandle));
+}
+YASIO_NI_API void yasio_resume_read(void* service_ptr, void* thandle)
+{
+  auto service = reinterpret_cast<io_service*>(service_ptr);
+  if (service)
+    service->resume_read(reinterpret_cast<transport_handle_t>(thandle));
+}
 YASIO_NI_API int yasio_write(void* service_ptr, void* thandle, const char* bytes, int len)
 {
   auto service = reinterpret_cast<io_service*>(service_ptr);
@@ -232,6 +280,31 @@ YASIO_NI_API int yasio_write(void* service_ptr, void* thandle, const char* bytes
     return service->write(reinterpret_cast<transport_handle_t>(thandle), yasio::sbyte_buffer(bytes, bytes + len));
   return -1;
 }
+YASIO_NI_API int yasio_broadcast(void* service_ptr, void** thandles, int count, const char* bytes, int len)
+{
+  auto service = reinterpret_cast<io_service*>(service_ptr);
+  if (service)
+    return service->broadcast(reinterpret_cast<transport_handle_t*>(thandles), count, std::make_shared<const yasio::sbyte_buffer>(bytes, bytes + len));
+  return -1;
+}
+YASIO_NI_API void yasio_join_group(void* service_ptr, void* thandle, const char* group)
+{
+  auto service = reinterpret_cast<io_service*>(service_ptr);
+  if (service)
+    service->join_group(reinterpret_cast<transport_handle_t>(thandle), group);
+}
+YASIO_NI_API void yasio_leave_group(void* service_ptr, void* thandle, const char* group)
+{
+  auto service = reinterpret_cast<io_service*>(service_ptr);
+  if (service)
+    service->leave_group(reinterpret_cast<transport_handle_t>(thandle), group);
+}
+YASIO_NI_API void yasio_publish(void* service_ptr, const char* group, const char* bytes, int len)
+{
+  auto service = reinterpret_cast<io_service*>(service_ptr);
+  if (service)
+    service->publish(group, std::make_shared<const yasio::sbyte_buffer>(bytes, bytes + len));
+}
 YASIO_NI_API int yasio_forward(void* service_ptr, void* thandle, void* bufferHandle,
                                const char*(YASIO_INTEROP_DECL* pfnLockBuffer)(void* bufferHandle, int* bufferDataLen),
                                void(YASIO_INTEROP_DECL* pfnUnlockBuffer)(void* bufferHandle))
@@ -107,6 +107,27 @@ SOFTWARE.
 #  define YASIO__UDP_KROUTE 1
 #endif
 
+// Tests whether current OS support recvmmsg/sendmmsg for udp batching io
+#if defined(__linux__) && !defined(__ANDROID__) || (defined(__ANDROID_API__) && __ANDROID_API__ >= 21)
+#  define YASIO__HAS_MMSG 1
+#else
+#  define YASIO__HAS_MMSG 0
+#endif
+
+// Tests whether current OS support MSG_ZEROCOPY for tcp send, linux 4.14+
+#if defined(__linux__)
+#  define YASIO__HAS_ZEROCOPY 1
+#else
+#  define YASIO__HAS_ZEROCOPY 0
+#endif
+
+// Tests whether current OS support sendfile/splice for file transfer
+#if defined(__linux__)
+#  define YASIO__HAS_SENDFILE 1
+#else
+#  define YASIO__HAS_SENDFILE 0
+#endif
+
 // Tests whether current OS is BSD-like system for process common BSD socket behaviors
 #if !defined(_WIN32) && !defined(__linux__)
 #  include <sys/param.h>
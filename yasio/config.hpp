@@ -48,6 +48,14 @@ SOFTWARE.
 */
 // #define YASIO_USE_SPSC_QUEUE 1
 
+/*
+** Uncomment or add compiler flag -DYASIO_USE_LOCKED_SEND_QUEUE to use std's queue + mutex for
+** the transport send queue
+** Remark: By default, the send ops posted to lock-free mpsc queue, the writing threads never
+**         contend with io thread.
+*/
+// #define YASIO_USE_LOCKED_SEND_QUEUE 1
+
 /*
 ** Uncomment or add compiler flag -DYASIO_USE_SHARED_PACKET to use std::shared_ptr wrap network packet.
 */
@@ -139,6 +147,12 @@ SOFTWARE.
 */
 // #define YASIO_ENABLE_HPERF_IO 1
 
+/*
+** Uncomment or add compiler flag -DYASIO_ENABLE_IO_URING to use io_uring for I/O multiplexing on linux 5.11+
+** Remark: fallback to poll when io_uring not available at runtime
+*/
+// #define YASIO_ENABLE_IO_URING 1
+
 #if defined(_WIN32)
 #  if defined(YASIO_ENABLE_HPERF_IO)
 #    undef YASIO__HAS_EPOLL
@@ -222,6 +236,18 @@ SOFTWARE.
 // The max Initial Bytes To Strip for unpack.
 #define YASIO_UNPACK_MAX_STRIP 32
 
+// The max queued send ops gathered to one sendmsg/WSASend of tcp transport.
+#define YASIO_MAX_SEND_IOVCNT 64
+
+// The max datagrams of udp recvmmsg/sendmmsg batch, see YOPT_S_UDP_BATCH.
+#define YASIO_MAX_UDP_BATCH 64
+
+// The max datagrams of one UDP_SEGMENT message, see YCF_UDP_GSO.
+#define YASIO_MAX_GSO_SEGMENTS 64
+
+// The chunk size of file reads when file can't be sent by sendfile/splice, i.e. ssl transport, see io_service::write_file.
+#define YASIO_SENDFILE_CHUNK_SIZE YASIO_SZ(64, k)
+
 // The fallback name servers when c-ares can't get name servers from system config,
 // For Android 8 or later, yasio will try to retrive through jni automitically,
 // For iOS, since c-ares-1.16.1, it will use libresolv for retrieving DNS servers.
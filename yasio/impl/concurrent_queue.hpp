@@ -28,11 +28,13 @@ SOFTWARE.
 #ifndef YASIO__CONCURRENT_QUEUE_HPP
 #define YASIO__CONCURRENT_QUEUE_HPP
 
+#include <mutex>
 #include "yasio/config.hpp"
 #if defined(YASIO_USE_SPSC_QUEUE)
 #  include "moodycamel/readerwriterqueue.h"
 #else
-#  include <queue>
+#  include <algorithm>
+#  include <deque>
 #endif
 
 namespace yasio
@@ -59,7 +61,18 @@ public:
     while (count-- > 0 && this->try_dequeue(event))
       func(std::move(event));
   }
+  size_t count() const { return this->size_approx(); }
   void clear() { clear_queue(static_cast<moodycamel::ReaderWriterQueue<_Ty>&>(*this)); }
+
+  // spsc queue can only peek the front item
+  template <typename _Fty>
+  std::unique_lock<std::recursive_mutex> peek_n(size_t count, _Fty&& func)
+  {
+    auto item = this->peek();
+    if (item && count > 0)
+      func(*item);
+    return std::unique_lock<std::recursive_mutex>{};
+  }
 };
 
 #else
@@ -99,10 +112,10 @@ public:
   void emplace(_Types&&... values)
   {
     std::lock_guard<std::recursive_mutex> lck(this->mtx_);
-    queue_.emplace(std::forward<_Types>(values)...);
+    queue_.emplace_back(std::forward<_Types>(values)...);
   }
 
-  void pop() { queue_.pop(); }
+  void pop() { queue_.pop_front(); }
   bool empty() const { return this->queue_.empty(); }
   void clear()
   {
@@ -123,8 +136,19 @@ public:
     return concurrent_item{};
   }
 
+  // peek at most count items from front to read/write thread safe, the queue keep locked until the returned lock released
+  template <typename _Fty>
+  std::unique_lock<std::recursive_mutex> peek_n(size_t count, _Fty&& func)
+  {
+    std::unique_lock<std::recursive_mutex> lck(this->mtx_);
+    count = (std::min)(count, queue_.size());
+    for (size_t i = 0; i < count; ++i)
+      func(queue_[i]);
+    return lck;
+  }
+
 protected:
-  std::queue<_Ty> queue_;
+  std::deque<_Ty> queue_;
   std::recursive_mutex mtx_;
 };
 template <typename _Ty>
@@ -149,7 +173,7 @@ public:
     while (count-- > 0 && !this->deal_.empty())
     {
       auto event = std::move(this->deal_.front());
-      deal_.pop();
+      deal_.pop_front();
       func(std::move(event));
     };
   }
@@ -163,7 +187,7 @@ public:
   }
 
 private:
-  std::queue<_Ty> deal_;
+  std::deque<_Ty> deal_;
 };
 #endif
 } // namespace privacy
@@ -0,0 +1,115 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A multi-platform support c++11 library with focus on asynchronous socket I/O for any
+// client application.
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2012-2024 HALX99 (halx99 at live dot com)
+#ifndef YASIO__DISPATCH_POOL_HPP
+#define YASIO__DISPATCH_POOL_HPP
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "yasio/compiler/feature_test.hpp"
+
+namespace yasio
+{
+/*
+ * The ordered dispatch thread pool
+ * - the items with same key always processed by the same worker in post order, the items of
+ *   different keys processed by workers in parallel, so one slow key only stalls it's worker
+ * - post: at any thread, the worker only notified when it's waiting
+ * - the worker takes all pending items at once, and processes them in batch without lock
+ */
+template <typename _Ty>
+class dispatch_pool {
+public:
+  typedef std::function<void(_Ty* items, size_t count)> handler_type;
+
+  dispatch_pool() = default;
+  dispatch_pool(const dispatch_pool&) = delete;
+  ~dispatch_pool() { stop(); }
+
+  bool started() const { return !workers_.empty(); }
+
+  void start(int threads, const handler_type& handler)
+  {
+    for (int i = 0; i < threads; ++i)
+    {
+      auto w      = std::make_shared<worker>();
+      w->handler_ = handler;
+      w->thread_  = std::thread(&dispatch_pool::run, w);
+      workers_.push_back(std::move(w));
+    }
+  }
+
+  void post(size_t key, _Ty&& item)
+  {
+    auto& w = *workers_[key % workers_.size()];
+    std::unique_lock<std::mutex> lck(w.mtx_);
+    w.queue_.push_back(std::move(item));
+    if (w.waiting_)
+    {
+      lck.unlock();
+      w.cv_.notify_one();
+    }
+  }
+
+  // process all posted items, then stop the workers
+  void stop()
+  {
+    for (auto& w : workers_)
+    {
+      std::lock_guard<std::mutex> lck(w->mtx_);
+      w->stopping_ = true;
+      w->cv_.notify_one();
+    }
+    for (auto& w : workers_)
+    { // stop at the handler of worker, the worker holds itself and exits after handler returns
+      if (w->thread_.get_id() == std::this_thread::get_id())
+        w->thread_.detach();
+      else
+        w->thread_.join();
+    }
+    workers_.clear();
+  }
+
+private:
+  struct worker {
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::vector<_Ty> queue_;
+    bool waiting_  = false;
+    bool stopping_ = false;
+    handler_type handler_;
+    std::thread thread_;
+  };
+
+  static void run(std::shared_ptr<worker> w)
+  {
+    std::vector<_Ty> batch;
+    for (;;)
+    {
+      {
+        std::unique_lock<std::mutex> lck(w->mtx_);
+        while (w->queue_.empty() && !w->stopping_)
+        {
+          w->waiting_ = true;
+          w->cv_.wait(lck);
+        }
+        w->waiting_ = false;
+        if (w->queue_.empty())
+          break;
+        std::swap(batch, w->queue_);
+      }
+      w->handler_(batch.data(), batch.size());
+      batch.clear();
+    }
+  }
+
+  std::vector<std::shared_ptr<worker>> workers_;
+};
+} // namespace yasio
+#endif
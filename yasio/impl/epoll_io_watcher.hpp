@@ -8,9 +8,9 @@
 #define YASIO__EPOLL_IO_WATCHER_HPP
 #include <vector>
 #include <chrono>
-#include <map>
 #include "yasio/pod_vector.hpp"
 #include "yasio/impl/socket.hpp"
+#include "yasio/impl/fd_table.hpp"
 #include "yasio/impl/select_interrupter.hpp"
 
 #if !defined(_WIN32)
@@ -45,9 +45,9 @@ public:
 
   void mod_event(socket_native_type fd, int add_events, int remove_events, int flags = 0)
   {
-    auto it               = events_.find(fd);
-    const auto registered = it != events_.end();
-    int underlying_events = registered ? it->second : 0;
+    auto& registered_events = events_.at(fd);
+    const auto registered   = registered_events != 0;
+    int underlying_events   = registered_events;
     underlying_events |= to_underlying_events(add_events);
     underlying_events &= ~to_underlying_events(remove_events);
 
@@ -59,10 +59,9 @@ public:
     { // add or mod
       if (::epoll_ctl(epoll_handle_, !registered ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &ev) == 0)
       {
-        if (registered)
-          it->second = underlying_events;
-        else
-          events_[fd] = underlying_events;
+        if (!registered)
+          ++nfds_;
+        registered_events = underlying_events;
       }
     }
     else
@@ -70,11 +69,13 @@ public:
       if (registered)
       {
         ::epoll_ctl(epoll_handle_, EPOLL_CTL_DEL, fd, &ev);
-        events_.erase(it);
+        events_.erase(fd);
+        ready_.reset(fd);
+        --nfds_;
       }
     }
 
-    max_events_ = (std::min)(static_cast<int>(events_.size()), 128);
+    max_events_ = (std::min)(nfds_, 128);
   }
 
   int poll_io(int64_t waitd_us)
@@ -89,7 +90,9 @@ public:
 #else
     int num_events   = ::epoll_wait(epoll_handle_, revents_.data(), static_cast<int>(revents_.size()), static_cast<int>(waitd_us / std::milli::den));
 #endif
-    nrevents_ = num_events;
+    ready_.clear();
+    for (int i = 0; i < num_events; ++i)
+      ready_.set(revents_[i].data.fd, to_socket_events(revents_[i].events));
     if (num_events > 0 && is_ready(this->interrupter_.read_descriptor(), socket_event::read))
       --num_events;
     return num_events;
@@ -99,22 +102,14 @@ public:
   {
     epoll_event ev = {0, {0}};
     ev.events      = EPOLLIN | EPOLLERR | EPOLLONESHOT;
-    ev.data.ptr    = &interrupter_;
+    ev.data.fd     = static_cast<int>(interrupter_.read_descriptor());
     epoll_ctl(epoll_handle_, EPOLL_CTL_MOD, interrupter_.read_descriptor(), &ev);
   }
 
-  int is_ready(socket_native_type fd, int events) const
-  {
-    int underlying_events = 0;
-    if (events & socket_event::read)
-      underlying_events |= EPOLLIN;
-    if (events & socket_event::write)
-      underlying_events |= EPOLLOUT;
-    if (events & socket_event::error)
-      underlying_events |= (EPOLLERR | EPOLLHUP | EPOLLPRI);
-    auto it = std::find_if(revents_.begin(), revents_.begin() + nrevents_, [fd](const epoll_event& ev) { return ev.data.fd == fd; });
-    return it != this->revents_.end() ? (it->events & underlying_events) : 0;
-  }
+  int is_ready(socket_native_type fd, int events) const { return ready_.get(fd, events); }
+
+  // The fds which have events at last poll_io
+  const yasio::pod_vector<socket_native_type>& ready_fds() const { return ready_.fds(); }
 
   int max_descriptor() const { return -1; }
 
@@ -135,6 +130,17 @@ protected:
     }
     return underlying_events;
   }
+  static int to_socket_events(uint32_t underlying_events)
+  {
+    int events = 0;
+    if (underlying_events & EPOLLIN)
+      events |= socket_event::read;
+    if (underlying_events & EPOLLOUT)
+      events |= socket_event::write;
+    if (underlying_events & (EPOLLERR | EPOLLHUP | EPOLLPRI))
+      events |= socket_event::error;
+    return events;
+  }
 
   enum
   {
@@ -158,9 +164,10 @@ protected:
   epoll_handle_t epoll_handle_;
 
   int max_events_ = 0;
-  int nrevents_   = 0;
-  std::map<socket_native_type, int> events_;
+  int nfds_       = 0;
+  fd_table<int> events_;
   yasio::pod_vector<epoll_event> revents_;
+  fd_ready_set ready_;
 
   select_interrupter interrupter_;
 };
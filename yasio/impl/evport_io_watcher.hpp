@@ -13,6 +13,7 @@
 
 #include "yasio/pod_vector.hpp"
 #include "yasio/impl/socket.hpp"
+#include "yasio/impl/fd_table.hpp"
 #include "yasio/impl/select_interrupter.hpp"
 
 /*
@@ -59,6 +60,7 @@ public:
       {
         ::port_dissociate(port_handle_, PORT_SOURCE_FD, fd);
         events_.erase(it);
+        ready_.reset(fd);
       }
     }
     max_events_ = (std::min)(static_cast<uint_t>(events_.size()), 128u);
@@ -85,7 +87,8 @@ public:
      * refer to: https://docs.oracle.com/cd/E19253-01/816-5168/port-create-3c/index.html
      */
     int interrupt_hint = 0;
-    for (int i = 0; i < num_events; ++i)
+    ready_.clear();
+    for (int i = 0; i < static_cast<int>(num_events); ++i)
     {
       auto event_source = revents_[i].portev_source;
       if (event_source != PORT_SOURCE_FD)
@@ -93,35 +96,38 @@ public:
         interrupt_hint = 1;
         continue;
       }
-      int fd                 = static_cast<int>(revents_[i].portev_object);
+      int fd = static_cast<int>(revents_[i].portev_object);
+      ready_.set(fd, to_socket_events(revents_[i].portev_events));
       auto underlying_events = events_[fd];
       if (underlying_events)
         ::port_associate(port_handle_, PORT_SOURCE_FD, fd, underlying_events, nullptr);
     }
 
-    nrevents_ = num_events;
-    num_events -= interrupt_hint;
+    return static_cast<int>(num_events) - interrupt_hint;
   }
 
   void wakeup() { ::port_send(port_handle_, POLLIN, nullptr); }
 
-  int is_ready(socket_native_type fd, int events) const
-  {
-    int underlying_events = 0;
-    if (events & socket_event::read)
-      underlying_events |= POLLIN;
-    if (events & socket_event::write)
-      underlying_events |= POLLOUT;
-    if (events & socket_event::error)
-      underlying_events |= (POLLERR | POLLHUP | POLLPRI);
-    auto it = std::find_if(revents_.begin(), this->revents_.begin() + static_cast<int>(nrevents_),
-                           [fd](const port_event_t& ev) { return static_cast<int>(ev.portev_object) == fd; });
-    return it != this->revents_.end() ? (it->portev_events & underlying_events) : 0;
-  }
+  int is_ready(socket_native_type fd, int events) const { return ready_.get(fd, events); }
+
+  // The fds which have events at last poll_io
+  const yasio::pod_vector<socket_native_type>& ready_fds() const { return ready_.fds(); }
 
   int max_descriptor() const { return -1; }
 
 protected:
+  static int to_socket_events(int underlying_events)
+  {
+    int events = 0;
+    if (underlying_events & POLLIN)
+      events |= socket_event::read;
+    if (underlying_events & POLLOUT)
+      events |= socket_event::write;
+    if (underlying_events & (POLLERR | POLLHUP | POLLPRI))
+      events |= socket_event::error;
+    return events;
+  }
+
   int to_underlying_events(int events)
   {
     int underlying_events = 0;
@@ -141,9 +147,9 @@ protected:
 
   int port_handle_;
   uint_t max_events_ = 0;
-  uint_t nrevents_   = 0;
   std::map<socket_native_type, int> events_;
   yasio::pod_vector<port_event_t> revents_;
+  fd_ready_set ready_;
 };
 } // namespace inet
 } // namespace yasio
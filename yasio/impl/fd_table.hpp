@@ -0,0 +1,98 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A multi-platform support c++11 library with focus on asynchronous socket I/O for any
+// client application.
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2012-2024 HALX99 (halx99 at live dot com)
+#ifndef YASIO__FD_TABLE_HPP
+#define YASIO__FD_TABLE_HPP
+#include "yasio/pod_vector.hpp"
+#include "yasio/impl/socket.hpp"
+#if defined(_WIN32)
+#  include <unordered_map>
+#endif
+
+namespace yasio
+{
+YASIO__NS_INLINE
+namespace inet
+{
+/*
+ * The socket.fd indexed table
+ * - posix: dense array, the fd is the index, O(1) lookup without hashing
+ * - win32: hash map, because SOCKET is an opaque handle not a small integer
+ */
+#if !defined(_WIN32)
+template <typename _Ty>
+class fd_table {
+public:
+  _Ty get(socket_native_type fd) const { return static_cast<size_t>(fd) < slots_.size() ? slots_[fd] : _Ty{}; }
+  _Ty& at(socket_native_type fd)
+  {
+    if (static_cast<size_t>(fd) >= slots_.size())
+      slots_.resize((std::max)(static_cast<size_t>(fd) + 1, slots_.size() << 1), _Ty{});
+    return slots_[fd];
+  }
+  void erase(socket_native_type fd)
+  {
+    if (static_cast<size_t>(fd) < slots_.size())
+      slots_[fd] = _Ty{};
+  }
+  void clear() { slots_.clear(); }
+
+private:
+  yasio::pod_vector<_Ty> slots_;
+};
+#else
+template <typename _Ty>
+class fd_table {
+public:
+  _Ty get(socket_native_type fd) const
+  {
+    auto it = slots_.find(fd);
+    return it != slots_.end() ? it->second : _Ty{};
+  }
+  _Ty& at(socket_native_type fd) { return slots_[fd]; }
+  void erase(socket_native_type fd) { slots_.erase(fd); }
+  void clear() { slots_.clear(); }
+
+private:
+  std::unordered_map<socket_native_type, _Ty> slots_;
+};
+#endif
+
+/*
+ * The ready set of last poll_io, filled by io_watcher per poll, value is socket_event mask
+ */
+class fd_ready_set {
+public:
+  void set(socket_native_type fd, int events)
+  {
+    if (!events)
+      return;
+    auto& slot = table_.at(fd);
+    if (!slot)
+      fds_.push_back(fd);
+    slot |= events;
+  }
+  int get(socket_native_type fd, int events) const { return table_.get(fd) & events; }
+
+  // drop readiness of fd, i.e. fd deregistered from watcher
+  void reset(socket_native_type fd) { table_.erase(fd); }
+
+  void clear()
+  {
+    for (auto fd : fds_)
+      table_.erase(fd);
+    fds_.clear();
+  }
+
+  const yasio::pod_vector<socket_native_type>& fds() const { return fds_; }
+
+private:
+  fd_table<int> table_;
+  yasio::pod_vector<socket_native_type> fds_;
+};
+} // namespace inet
+} // namespace yasio
+#endif
@@ -0,0 +1,340 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A multi-platform support c++11 library with focus on asynchronous socket I/O for any
+// client application.
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2012-2024 HALX99 (halx99 at live dot com)
+#ifndef YASIO__IO_URING_IO_WATCHER_HPP
+#define YASIO__IO_URING_IO_WATCHER_HPP
+#include <chrono>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+#include <linux/io_uring.h>
+#include "yasio/impl/poll_io_watcher.hpp"
+
+/*
+ * The io_uring io_watcher, linux 5.11+ required
+ * - all mod_event are batched as poll sqes, and submitted with waiting completions by one io_uring_enter
+ * - the poll sqe is one-shot and re-armed after completion, because the event loop relies on level-triggered
+ *   readiness, i.e. recv at most one buffer per transport per loop, the multishot poll only reports new arrivals
+ * - the interrupter use multishot poll, because it's always drained by interrupter_.reset
+ * - the poll sqe can't be got when sq ring full and the kernel can't consume it, i.e. EBUSY by cq overflow,
+ *   the fd is re-armed at next poll_io, which doesn't wait until all fds armed
+ * - fallback to poll_io_watcher when io_uring not available, i.e. disabled by sysctl/seccomp or old kernels
+ */
+
+namespace yasio
+{
+YASIO__NS_INLINE
+namespace inet
+{
+class io_uring_io_watcher : public poll_io_watcher {
+  struct poll_state {
+    int events;       // underlying poll events
+    unsigned int tag; // the tag of armed poll sqe, 0: not armed
+    int flags;        // the poll sqe flags, i.e. IORING_POLL_ADD_MULTI
+    bool deferred;    // in unarmed_, not armed for no sqe available
+  };
+
+public:
+  io_uring_io_watcher(unsigned int entries = 1024)
+  {
+    if (setup_ring(entries))
+      this->mod_event(interrupter_.read_descriptor(), socket_event::read, 0, IORING_POLL_ADD_MULTI);
+  }
+  ~io_uring_io_watcher()
+  {
+    if (ring_fd_ != -1)
+    {
+      ::munmap(sqes_, sqes_size_);
+      if (cq_ring_ != sq_ring_)
+        ::munmap(cq_ring_, cq_ring_size_);
+      ::munmap(sq_ring_, sq_ring_size_);
+      ::close(ring_fd_);
+    }
+  }
+
+  void mod_event(socket_native_type fd, int add_events, int remove_events, int flags = 0)
+  {
+    if (ring_fd_ == -1)
+      return poll_io_watcher::mod_event(fd, add_events, remove_events);
+
+    auto& state           = states_.at(fd);
+    int underlying_events = (state.events | to_underlying_events(add_events)) & ~to_underlying_events(remove_events);
+    if (underlying_events == state.events)
+      return;
+
+    if (state.tag)
+    { // cancel the armed poll, the stale completions filtered by tag
+      prep_poll_remove(make_user_data(fd, state.tag));
+      state.tag = 0;
+    }
+    if (underlying_events)
+    {
+      state.events = underlying_events;
+      state.flags |= flags;
+      prep_poll_add(fd, state);
+    }
+    else
+    {
+      states_.erase(fd);
+      ready_.reset(fd);
+    }
+  }
+
+  int poll_io(int64_t waitd_us)
+  {
+    if (ring_fd_ == -1)
+      return poll_io_watcher::poll_io(waitd_us);
+
+    // re-arm the fds failed by sq ring full, and don't wait if still any, the readiness of them not reported by kernel
+    if (!unarmed_.empty() && !rearm_unarmed())
+      waitd_us = 0;
+
+    struct __kernel_timespec timeout = {(decltype(__kernel_timespec::tv_sec))(waitd_us / std::micro::den),
+                                        (decltype(__kernel_timespec::tv_nsec))((waitd_us % std::micro::den) * std::milli::den)};
+    struct io_uring_getevents_arg arg;
+    ::memset(&arg, 0, sizeof(arg));
+    arg.sigmask_sz = _NSIG / 8;
+    arg.ts         = reinterpret_cast<uint64_t>(&timeout);
+
+    // submit all pending sqes and wait completions with only one syscall
+    int ret = io_uring_enter(sq_pending_, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    if (ret >= 0)
+      sq_pending_ -= (std::min)(sq_pending_, static_cast<unsigned int>(ret));
+    else
+    {
+      int ec = errno;
+      if (ec != ETIME && ec != EINTR && ec != EBUSY && ec != EAGAIN)
+        return -1;
+    }
+
+    ready_.clear();
+    reap_completions();
+
+    int num_events = static_cast<int>(ready_.fds().size());
+    if (num_events > 0 && is_ready(this->interrupter_.read_descriptor(), socket_event::read))
+    {
+      if (!interrupter_.reset())
+        interrupter_.recreate();
+      --num_events;
+    }
+    return num_events;
+  }
+
+protected:
+  bool setup_ring(unsigned int entries)
+  {
+    struct io_uring_params params;
+    ::memset(&params, 0, sizeof(params));
+    int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0)
+      return false;
+    if (!(params.features & IORING_FEAT_EXT_ARG))
+    { // the wait timeout requires io_uring_enter with ext arg, linux 5.11+
+      ::close(fd);
+      return false;
+    }
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+      sq_ring_size_ = cq_ring_size_ = (std::max)(sq_ring_size_, cq_ring_size_);
+
+    sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED)
+    {
+      ::close(fd);
+      return false;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+      cq_ring_ = sq_ring_;
+    else
+    {
+      cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+      if (cq_ring_ == MAP_FAILED)
+      {
+        ::munmap(sq_ring_, sq_ring_size_);
+        ::close(fd);
+        return false;
+      }
+    }
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes_      = static_cast<struct io_uring_sqe*>(::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+    if (sqes_ == MAP_FAILED)
+    {
+      if (cq_ring_ != sq_ring_)
+        ::munmap(cq_ring_, cq_ring_size_);
+      ::munmap(sq_ring_, sq_ring_size_);
+      ::close(fd);
+      return false;
+    }
+
+    auto sq_base = static_cast<char*>(sq_ring_);
+    sq_head_     = reinterpret_cast<unsigned int*>(sq_base + params.sq_off.head);
+    sq_tail_     = reinterpret_cast<unsigned int*>(sq_base + params.sq_off.tail);
+    sq_mask_     = *reinterpret_cast<unsigned int*>(sq_base + params.sq_off.ring_mask);
+    sq_entries_  = params.sq_entries;
+    // identity mapping, the sqe index always equals to sq ring index
+    auto sq_array = reinterpret_cast<unsigned int*>(sq_base + params.sq_off.array);
+    for (unsigned int i = 0; i < sq_entries_; ++i)
+      sq_array[i] = i;
+
+    auto cq_base = static_cast<char*>(cq_ring_);
+    cq_head_     = reinterpret_cast<unsigned int*>(cq_base + params.cq_off.head);
+    cq_tail_     = reinterpret_cast<unsigned int*>(cq_base + params.cq_off.tail);
+    cq_mask_     = *reinterpret_cast<unsigned int*>(cq_base + params.cq_off.ring_mask);
+    cqes_        = reinterpret_cast<struct io_uring_cqe*>(cq_base + params.cq_off.cqes);
+
+    ring_fd_ = fd;
+    return true;
+  }
+
+  int io_uring_enter(unsigned int to_submit, unsigned int min_complete, unsigned int flags, void* arg, size_t argsz)
+  {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, flags, arg, argsz));
+  }
+
+  struct io_uring_sqe* get_sqe()
+  {
+    auto tail = *sq_tail_;
+    if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_)
+    { // sq ring full, submit without waiting
+      int ret = io_uring_enter(sq_pending_, 0, 0, nullptr, 0);
+      if (ret > 0)
+        sq_pending_ -= (std::min)(sq_pending_, static_cast<unsigned int>(ret));
+      if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_)
+        return nullptr;
+    }
+    auto sqe = &sqes_[tail & sq_mask_];
+    ::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+  }
+
+  void commit_sqe()
+  {
+    __atomic_store_n(sq_tail_, *sq_tail_ + 1, __ATOMIC_RELEASE);
+    ++sq_pending_;
+  }
+
+  void prep_poll_add(socket_native_type fd, poll_state& state)
+  {
+    auto sqe = get_sqe();
+    if (!sqe)
+    {
+      if (!state.deferred)
+      {
+        state.deferred = true;
+        unarmed_.push_back(fd);
+      }
+      return;
+    }
+    if (++tag_seed_ == 0)
+      tag_seed_ = 1;
+    state.tag           = tag_seed_;
+    sqe->opcode         = IORING_OP_POLL_ADD;
+    sqe->fd             = fd;
+    sqe->poll32_events  = static_cast<uint32_t>(state.events);
+    sqe->len            = static_cast<uint32_t>(state.flags);
+    sqe->user_data      = make_user_data(fd, state.tag);
+    commit_sqe();
+  }
+
+  // returns whether all unarmed fds armed
+  bool rearm_unarmed()
+  {
+    auto fds = std::move(unarmed_);
+    unarmed_.clear();
+    for (auto fd : fds)
+    {
+      if (!states_.get(fd).deferred)
+        continue; // removed by mod_event
+      auto& state    = states_.at(fd);
+      state.deferred = false;
+      if (!state.tag)
+        prep_poll_add(fd, state);
+    }
+    return unarmed_.empty();
+  }
+
+  void prep_poll_remove(uint64_t target)
+  {
+    auto sqe = get_sqe();
+    if (!sqe)
+      return; // the armed poll still in kernel, it's completion is stale and filtered by tag
+    sqe->opcode    = IORING_OP_POLL_REMOVE;
+    sqe->fd        = -1;
+    sqe->addr      = target;
+    sqe->user_data = 0; // ignore it's completion
+    commit_sqe();
+  }
+
+  void reap_completions()
+  {
+    auto head = *cq_head_;
+    auto tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head)
+    {
+      auto& cqe = cqes_[head & cq_mask_];
+      if (cqe.user_data == 0)
+        continue;
+      auto fd   = static_cast<socket_native_type>(cqe.user_data & 0xffffffff);
+      auto tag  = static_cast<unsigned int>(cqe.user_data >> 32);
+      auto& state = states_.at(fd);
+      if (state.tag != tag)
+        continue; // stale completion of cancelled poll
+
+      if (cqe.res >= 0)
+        ready_.set(fd, to_socket_events(cqe.res));
+      else if (cqe.res == -EINVAL && (state.flags & IORING_POLL_ADD_MULTI))
+        state.flags &= ~IORING_POLL_ADD_MULTI; // multishot poll not supported, linux 5.13+ required
+      else
+      { // poll failed, don't re-arm
+        if (cqe.res != -ECANCELED)
+          ready_.set(fd, socket_event::error);
+        state.tag = 0;
+        continue;
+      }
+
+      if (!(cqe.flags & IORING_CQE_F_MORE))
+        prep_poll_add(fd, state); // re-arm
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  }
+
+  static uint64_t make_user_data(socket_native_type fd, unsigned int tag)
+  {
+    return (static_cast<uint64_t>(tag) << 32) | static_cast<uint32_t>(fd);
+  }
+
+  int ring_fd_ = -1;
+
+  void* sq_ring_       = nullptr;
+  size_t sq_ring_size_ = 0;
+  unsigned int* sq_head_;
+  unsigned int* sq_tail_;
+  unsigned int sq_mask_    = 0;
+  unsigned int sq_entries_ = 0;
+  unsigned int sq_pending_ = 0;
+
+  void* cq_ring_       = nullptr;
+  size_t cq_ring_size_ = 0;
+  unsigned int* cq_head_;
+  unsigned int* cq_tail_;
+  unsigned int cq_mask_ = 0;
+  struct io_uring_cqe* cqes_;
+
+  struct io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_          = 0;
+
+  unsigned int tag_seed_ = 0;
+  fd_table<poll_state> states_;
+  std::vector<socket_native_type> unarmed_; // the fds failed to arm, see prep_poll_add
+};
+} // namespace inet
+} // namespace yasio
+#endif
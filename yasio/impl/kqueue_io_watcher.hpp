@@ -13,6 +13,7 @@
 #include <map>
 #include "yasio/pod_vector.hpp"
 #include "yasio/impl/socket.hpp"
+#include "yasio/impl/fd_table.hpp"
 #include "yasio/impl/select_interrupter.hpp"
 
 #if defined(__NetBSD__) && __NetBSD_Version__ < 999001500
@@ -56,7 +57,12 @@ public:
     timespec timeout = {(decltype(timespec::tv_sec))(waitd_us / std::micro::den),
                         (decltype(timespec::tv_nsec))((waitd_us % std::micro::den) * std::milli::den)};
     int num_events   = kevent(kqueue_fd_, 0, 0, revents_.data(), static_cast<int>(revents_.size()), &timeout);
-    nrevents_ = num_events;
+    ready_.clear();
+    for (int i = 0; i < num_events; ++i)
+    {
+      auto& ev = revents_[i];
+      ready_.set(static_cast<socket_native_type>(reinterpret_cast<intptr_t>(ev.udata)), to_socket_events(ev));
+    }
     if (num_events > 0 && is_ready(this->interrupter_.read_descriptor(), socket_event::read))
     {
       if (!interrupter_.reset())
@@ -68,36 +74,33 @@ public:
 
   void wakeup() { interrupter_.interrupt(); }
 
-  int is_ready(socket_native_type fd, int events) const
+  int is_ready(socket_native_type fd, int events) const { return ready_.get(fd, events); }
+
+  // The fds which have events at last poll_io
+  const yasio::pod_vector<socket_native_type>& ready_fds() const { return ready_.fds(); }
+
+  int max_descriptor() const { return -1; }
+
+protected:
+  static int to_socket_events(const struct kevent& ev)
   {
-    auto it = std::find_if(revents_.begin(), this->revents_.begin() + nrevents_, [fd, events](const struct kevent& ev) {
-      int rfd = static_cast<int>(reinterpret_cast<intptr_t>(ev.udata));
-      if (rfd == fd)
-      {
-        if (ev.flags & EV_ERROR)
-          return !!(events & socket_event::error);
-        switch (ev.filter)
-        {
-          case EVFILT_READ:
-            return !!(events & socket_event::read);
-          case EVFILT_WRITE:
-            return !!(events & socket_event::write);
+    if (ev.flags & EV_ERROR)
+      return socket_event::error;
+    switch (ev.filter)
+    {
+      case EVFILT_READ:
+        return socket_event::read;
+      case EVFILT_WRITE:
+        return socket_event::write;
 #if defined(EVFILT_EXCEPT)
-          case EVFILT_EXCEPT:
-            return !!(events & socket_event::error);
+      case EVFILT_EXCEPT:
+        return socket_event::error;
 #endif
-          default:
-            return false;
-        }
-      }
-      return false;
-    });
-    return it != revents_.end() ? -it->filter : 0;
+      default:
+        return 0;
+    }
   }
 
-  int max_descriptor() const { return -1; }
-
-protected:
   void register_event(socket_native_type fd, int events)
   {
     int prev_events = events_[fd];
@@ -176,7 +179,10 @@ protected:
         if (curr_events != 0)
           events_[fd] = curr_events;
         else
+        {
           events_.erase(fd);
+          ready_.reset(fd);
+        }
         int diff = nkvlist - curr_count;
         if (diff != 0)
           max_events_ += diff;
@@ -186,9 +192,9 @@ protected:
 
   int kqueue_fd_;
   int max_events_ = 0;
-  int nrevents_ = 0;
   std::map<socket_native_type, int> events_;
   yasio::pod_vector<struct kevent> revents_;
+  fd_ready_set ready_;
   select_interrupter interrupter_;
 };
 } // namespace inet
@@ -0,0 +1,133 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A multi-platform support c++11 library with focus on asynchronous socket I/O for any
+// client application.
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2012-2024 HALX99 (halx99 at live dot com)
+#ifndef YASIO__MIRRORED_BUFFER_HPP
+#define YASIO__MIRRORED_BUFFER_HPP
+#include <stdlib.h>
+#include <string.h>
+#include "yasio/compiler/feature_test.hpp"
+#if defined(__linux__)
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#  if defined(__NR_memfd_create)
+#    define YASIO__HAS_MIRRORED_MMAP 1
+#  endif
+#endif
+#if !defined(YASIO__HAS_MIRRORED_MMAP)
+#  define YASIO__HAS_MIRRORED_MMAP 0
+#endif
+
+namespace yasio
+{
+YASIO__NS_INLINE
+namespace inet
+{
+/*
+ * The circular receive buffer, the readable bytes always contiguous
+ * - linux: the memfd pages mapped twice back to back, so the bytes wrap around the end are
+ *   visible contiguously at the mirror, no compaction at all
+ * - other platforms or mirror mapping failed: a linear buffer, the remain bytes compacted
+ *   to head only when tail space less than 1/4 capacity, not per consume
+ */
+class mirrored_buffer {
+public:
+  mirrored_buffer() = default;
+  mirrored_buffer(const mirrored_buffer&) = delete;
+  ~mirrored_buffer() { release(); }
+
+  bool init(size_t capacity)
+  {
+    release();
+#if YASIO__HAS_MIRRORED_MMAP
+    const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    capacity               = (capacity + page_size - 1) / page_size * page_size;
+    int fd                 = static_cast<int>(::syscall(__NR_memfd_create, "yasio-ring", 1 /*MFD_CLOEXEC*/));
+    if (fd != -1)
+    {
+      if (::ftruncate(fd, static_cast<off_t>(capacity)) == 0)
+      {
+        auto base = static_cast<char*>(::mmap(nullptr, capacity << 1, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (base != MAP_FAILED)
+        {
+          if (::mmap(base, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+              ::mmap(base + capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED)
+          {
+            data_     = base;
+            mirrored_ = true;
+          }
+          else
+            ::munmap(base, capacity << 1);
+        }
+      }
+      ::close(fd);
+    }
+#endif
+    if (!data_)
+      data_ = static_cast<char*>(::malloc(capacity));
+    capacity_ = data_ ? capacity : 0;
+    return data_ != nullptr;
+  }
+
+  size_t capacity() const { return capacity_; }
+  bool mirrored() const { return mirrored_; }
+
+  // the readable bytes
+  char* data() { return data_ + head_; }
+  size_t size() const { return tail_ - head_; }
+
+  // prepare writable space at tail, returns the contiguous space
+  size_t prepare()
+  {
+    if (!mirrored_ && head_ > 0 && (capacity_ - tail_) < (capacity_ >> 2))
+    {
+      ::memmove(data_, data_ + head_, tail_ - head_);
+      tail_ -= head_;
+      head_ = 0;
+    }
+    return mirrored_ ? capacity_ - size() : capacity_ - tail_;
+  }
+  char* tail() { return data_ + tail_; }
+  void commit(size_t n) { tail_ += n; }
+
+  void consume(size_t n)
+  {
+    head_ += n;
+    if (head_ == tail_)
+      head_ = tail_ = 0;
+    else if (head_ >= capacity_) // mirrored only, move to the first mapping
+    {
+      head_ -= capacity_;
+      tail_ -= capacity_;
+    }
+  }
+
+private:
+  void release()
+  {
+    if (data_)
+    {
+#if YASIO__HAS_MIRRORED_MMAP
+      if (mirrored_)
+        ::munmap(data_, capacity_ << 1);
+      else
+#endif
+        ::free(data_);
+    }
+    data_     = nullptr;
+    capacity_ = head_ = tail_ = 0;
+    mirrored_ = false;
+  }
+
+  char* data_      = nullptr;
+  size_t capacity_ = 0;
+  size_t head_     = 0; // read position
+  size_t tail_     = 0; // write position, head_ <= tail_ <= head_ + capacity_
+  bool mirrored_   = false;
+};
+} // namespace inet
+} // namespace yasio
+#endif
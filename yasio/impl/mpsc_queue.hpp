@@ -0,0 +1,173 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A multi-platform support c++11 library with focus on asynchronous socket I/O for any
+// client application.
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2012-2024 HALX99 (halx99 at live dot com)
+#ifndef YASIO__MPSC_QUEUE_HPP
+#define YASIO__MPSC_QUEUE_HPP
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include "yasio/compiler/feature_test.hpp"
+
+namespace yasio
+{
+// The hook of intrusive mpsc queue, the element type derives from it, so push needs no allocation
+struct mpsc_node {
+  std::atomic<mpsc_node*> mpsc_next_{nullptr};
+};
+
+/*
+ * The unbounded lock-free intrusive multi-producer single-consumer queue, by Dmitry Vyukov
+ * - push: wait-free, one atomic exchange, safe to call at any thread
+ * - pop: lock-free, only the consumer thread can call, may returns nullptr spuriously
+ *   when a producer preempted between exchange and link, the element will be visible
+ *   at next pop, so the producer should wakeup consumer after push
+ * - the queue doesn't own the nodes, the consumer takes ownership of popped node
+ */
+class intrusive_mpsc_queue {
+public:
+  intrusive_mpsc_queue() : head_(&stub_), tail_(&stub_) {}
+  intrusive_mpsc_queue(const intrusive_mpsc_queue&) = delete;
+
+  void push(mpsc_node* n)
+  {
+    n->mpsc_next_.store(nullptr, std::memory_order_relaxed);
+    mpsc_node* prev = head_.exchange(n, std::memory_order_acq_rel);
+    prev->mpsc_next_.store(n, std::memory_order_release);
+  }
+
+  mpsc_node* pop()
+  {
+    mpsc_node* tail = tail_;
+    mpsc_node* next = tail->mpsc_next_.load(std::memory_order_acquire);
+    if (tail == &stub_)
+    { // skip the stub
+      if (!next)
+        return nullptr;
+      tail_ = tail = next;
+      next  = next->mpsc_next_.load(std::memory_order_acquire);
+    }
+    if (!next)
+    {
+      if (tail != head_.load(std::memory_order_acquire))
+        return nullptr; // the producer linking, retry later
+      // the last node can't be popped until has successor, so push the stub back
+      push(&stub_);
+      next = tail->mpsc_next_.load(std::memory_order_acquire);
+      if (!next)
+        return nullptr;
+    }
+    tail_ = next;
+    return tail;
+  }
+
+  // only the consumer thread can call, the element still linking by producer not counted
+  bool empty() const { return tail_ == &stub_ && stub_.mpsc_next_.load(std::memory_order_acquire) == nullptr; }
+
+private:
+  std::atomic<mpsc_node*> head_; // the producers push at head
+  mpsc_node* tail_;              // the consumer pop at tail
+  mpsc_node stub_;
+};
+
+// The value mpsc queue, one node allocated per push
+template <typename _Ty>
+class mpsc_queue {
+  struct node : public mpsc_node {
+    _Ty value;
+  };
+
+public:
+  mpsc_queue() = default;
+  mpsc_queue(const mpsc_queue&) = delete;
+  ~mpsc_queue()
+  {
+    _Ty value;
+    while (pop(value))
+      ;
+  }
+
+  void push(_Ty&& value)
+  {
+    auto n   = new node();
+    n->value = std::move(value);
+    queue_.push(n);
+  }
+
+  bool pop(_Ty& value)
+  {
+    auto n = static_cast<node*>(queue_.pop());
+    if (!n)
+      return false;
+    value = std::move(n->value);
+    delete n;
+    return true;
+  }
+
+  bool empty() const { return queue_.empty(); }
+
+private:
+  intrusive_mpsc_queue queue_;
+};
+
+namespace privacy
+{
+/*
+ * The concurrent_queue compatible queue of unique_ptr<_Ty>, _Ty must derive from mpsc_node
+ * - emplace: at any thread, the element released into the lock-free inbox, never blocked by consumer
+ * - peek/peek_n/pop: consumer only, the inbox elements moved to the consumer local deque first,
+ *   so the consumer holds no lock while performing syscalls with the peeked elements
+ */
+template <typename _Ty>
+class intrusive_concurrent_queue {
+public:
+  using pointer = std::unique_ptr<_Ty>;
+
+  intrusive_concurrent_queue() = default;
+  intrusive_concurrent_queue(const intrusive_concurrent_queue&) = delete;
+  ~intrusive_concurrent_queue() { clear(); }
+
+  void emplace(pointer&& value) { inbox_.push(value.release()); }
+
+  void pop() { queue_.pop_front(); }
+  bool empty() const { return queue_.empty() && inbox_.empty(); }
+  void clear()
+  {
+    fetch();
+    queue_.clear();
+  }
+
+  // returns the front item, nullptr if empty
+  pointer* peek()
+  {
+    fetch();
+    return !queue_.empty() ? &queue_.front() : nullptr;
+  }
+
+  // peek at most count items from front, no lock required, returns a dummy lock to keep the same usage with concurrent_queue
+  template <typename _Fty>
+  std::unique_lock<std::recursive_mutex> peek_n(size_t count, _Fty&& func)
+  {
+    fetch();
+    for (size_t i = 0; i < count && i < queue_.size(); ++i)
+      func(queue_[i]);
+    return std::unique_lock<std::recursive_mutex>{};
+  }
+
+private:
+  void fetch()
+  {
+    while (auto n = inbox_.pop())
+      queue_.emplace_back(static_cast<_Ty*>(n));
+  }
+
+  intrusive_mpsc_queue inbox_;
+  std::deque<pointer> queue_;
+};
+} // namespace privacy
+} // namespace yasio
+#endif
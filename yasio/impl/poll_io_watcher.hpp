@@ -6,8 +6,10 @@
 // Copyright (c) 2012-2024 HALX99 (halx99 at live dot com)
 #ifndef YASIO__POLL_IO_WATCHER_HPP
 #define YASIO__POLL_IO_WATCHER_HPP
+#include <chrono>
 #include "yasio/pod_vector.hpp"
 #include "yasio/impl/socket.hpp"
+#include "yasio/impl/fd_table.hpp"
 #include "yasio/impl/select_interrupter.hpp"
 
 namespace yasio
@@ -21,7 +23,8 @@ public:
 
   void mod_event(socket_native_type fd, int add_events, int remove_events)
   {
-    pollfd_mod(this->events_, fd, to_underlying_events(add_events), to_underlying_events(remove_events));
+    if (!pollfd_mod(fd, to_underlying_events(add_events), to_underlying_events(remove_events)))
+      ready_.reset(fd);
   }
 
   int poll_io(int64_t waitd_us)
@@ -34,6 +37,13 @@ public:
 #else
     int num_events = ::poll(this->revents_.data(), static_cast<int>(this->revents_.size()), static_cast<int>(waitd_us / std::milli::den));
 #endif
+    ready_.clear();
+    if (num_events > 0)
+    {
+      for (auto& pfd : revents_)
+        if (pfd.revents)
+          ready_.set(pfd.fd, to_socket_events(pfd.revents));
+    }
     if (num_events > 0 && is_ready(this->interrupter_.read_descriptor(), socket_event::read))
     {
       if (!interrupter_.reset())
@@ -45,18 +55,10 @@ public:
 
   void wakeup() { interrupter_.interrupt(); }
 
-  int is_ready(socket_native_type fd, int events) const
-  {
-    int underlying_events = 0;
-    if (events & socket_event::read)
-      underlying_events |= POLLIN;
-    if (events & socket_event::write)
-      underlying_events |= POLLOUT;
-    if (events & socket_event::error)
-      underlying_events |= (POLLERR | POLLHUP | POLLNVAL);
-    auto it = std::find_if(this->revents_.begin(), this->revents_.end(), [fd](const pollfd& pfd) { return pfd.fd == fd; });
-    return it != this->revents_.end() ? (it->revents & underlying_events) : 0;
-  }
+  int is_ready(socket_native_type fd, int events) const { return ready_.get(fd, events); }
+
+  // The fds which have events at last poll_io
+  const yasio::pod_vector<socket_native_type>& ready_fds() const { return ready_.fds(); }
 
   int max_descriptor() const { return -1; }
 
@@ -77,27 +79,54 @@ protected:
     }
     return underlying_events;
   }
-  static void pollfd_mod(yasio::pod_vector<pollfd>& fdset, socket_native_type fd, int add_events, int remove_events)
+  static int to_socket_events(int underlying_events)
+  {
+    int events = 0;
+    if (underlying_events & POLLIN)
+      events |= socket_event::read;
+    if (underlying_events & POLLOUT)
+      events |= socket_event::write;
+    if (underlying_events & (POLLERR | POLLHUP | POLLNVAL))
+      events |= socket_event::error;
+    return events;
+  }
+  // returns the events still registered of fd
+  int pollfd_mod(socket_native_type fd, int add_events, int remove_events)
   {
-    auto it = std::find_if(fdset.begin(), fdset.end(), [fd](const pollfd& pfd) { return pfd.fd == fd; });
-    if (it != fdset.end())
+    auto& index = indices_.at(fd); // the index + 1 of fd in events_, 0: not registered
+    if (index)
     {
-      it->events |= add_events;
-      it->events &= ~remove_events;
-      if (it->events == 0)
-        fdset.erase(it);
+      auto& pfd = events_[index - 1];
+      pfd.events |= add_events;
+      pfd.events &= ~remove_events;
+      if (pfd.events == 0)
+      { // swap with last, avoid shift all
+        auto& back = events_.back();
+        if (&pfd != &back)
+        {
+          pfd                 = back;
+          indices_.at(pfd.fd) = index;
+        }
+        events_.resize(events_.size() - 1);
+        indices_.erase(fd);
+        return 0;
+      }
+      return pfd.events;
     }
-    else
+    auto events = add_events & ~remove_events;
+    if (events)
     {
-      auto events = add_events & ~remove_events;
-      if (events)
-        fdset.emplace_back(fd, static_cast<short>(events), static_cast<short>(0));
+      events_.emplace_back(fd, static_cast<short>(events), static_cast<short>(0));
+      index = static_cast<int>(events_.size());
     }
+    return events;
   }
 
 protected:
   yasio::pod_vector<pollfd> events_;
   yasio::pod_vector<pollfd> revents_;
+  fd_table<int> indices_;
+  fd_ready_set ready_;
 
   select_interrupter interrupter_;
 };
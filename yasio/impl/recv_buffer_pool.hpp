@@ -0,0 +1,87 @@
+//////////////////////////////////////////////////////////////////////////////////////////
+// A multi-platform support c++11 library with focus on asynchronous socket I/O for any
+// client application.
+//////////////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2012-2024 HALX99 (halx99 at live dot com)
+#ifndef YASIO__RECV_BUFFER_POOL_HPP
+#define YASIO__RECV_BUFFER_POOL_HPP
+#include <stddef.h>
+#include <new>
+#include <vector>
+#include "yasio/compiler/feature_test.hpp"
+
+namespace yasio
+{
+YASIO__NS_INLINE
+namespace inet
+{
+/*
+ * The size-classed recv buffer pool of io_service, not thread safe, only access at io thread
+ * - the size classes: 256, 1K, 4K, 16K, 64K
+ * - the transport borrows the largest class while reading, and keeps the smallest class which
+ *   holds the pending bytes of partial frame, the idle transport holds nothing
+ * - at most max_cached free buffers cached per class, the others released to system
+ */
+class recv_buffer_pool {
+public:
+  enum
+  {
+    min_class_bits  = 8,
+    class_step_bits = 2,
+    max_classes     = 5,
+    max_cached      = 32,
+  };
+
+  recv_buffer_pool() = default;
+  recv_buffer_pool(const recv_buffer_pool&) = delete;
+  ~recv_buffer_pool() { clear(); }
+
+  static size_t class_size(int cls) { return static_cast<size_t>(1) << (min_class_bits + cls * class_step_bits); }
+
+  // the smallest class which can holds size bytes
+  static int class_of(size_t size)
+  {
+    int cls = 0;
+    while (cls < max_classes - 1 && class_size(cls) < size)
+      ++cls;
+    return cls;
+  }
+
+  char* acquire(int cls)
+  {
+    auto& cached = free_[cls];
+    if (!cached.empty())
+    {
+      auto buf = cached.back();
+      cached.pop_back();
+      return buf;
+    }
+    return static_cast<char*>(::operator new(class_size(cls)));
+  }
+
+  void release(char* buf, int cls)
+  {
+    auto& cached = free_[cls];
+    if (cached.size() < max_cached)
+      cached.push_back(buf);
+    else
+      ::operator delete(buf);
+  }
+
+  void clear()
+  {
+    for (auto& cached : free_)
+    {
+      for (auto buf : cached)
+        ::operator delete(buf);
+      cached.clear();
+    }
+  }
+
+private:
+  std::vector<char*> free_[max_classes];
+};
+} // namespace inet
+} // namespace yasio
+#endif
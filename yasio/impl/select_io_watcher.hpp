@@ -8,6 +8,7 @@
 #define YASIO__SELECT_IO_WATCHER_HPP
 #include <vector>
 #include <chrono>
+#include "yasio/pod_vector.hpp"
 #include "yasio/impl/socket.hpp"
 #include "yasio/impl/select_interrupter.hpp"
 
@@ -61,6 +62,7 @@ public:
     ::memcpy(this->revents_, events_, sizeof(revents_));
     timeval timeout = {(decltype(timeval::tv_sec))(waitd_us / std::micro::den), (decltype(timeval::tv_usec))(waitd_us % std::micro::den)};
     int num_events  = ::select(this->max_descriptor_, &(revents_[read_op]), &(revents_[write_op]), nullptr, &timeout);
+    collect_ready_fds(num_events);
     if (num_events > 0 && is_ready(this->interrupter_.read_descriptor(), socket_event::read))
     {
       if (!interrupter_.reset())
@@ -84,9 +86,28 @@ public:
     return retval;
   }
 
+  // The fds which have events at last poll_io, may contains duplicated fd
+  const yasio::pod_vector<socket_native_type>& ready_fds() const { return ready_fds_; }
+
   int max_descriptor() const { return max_descriptor_; }
 
 protected:
+  void collect_ready_fds(int num_events)
+  {
+    ready_fds_.clear();
+    if (num_events <= 0)
+      return;
+#if defined(_WIN32)
+    for (int op = read_op; op <= write_op; ++op)
+      for (u_int i = 0; i < revents_[op].fd_count; ++i)
+        ready_fds_.push_back(revents_[op].fd_array[i]);
+#else
+    for (int fd = 0; fd < max_descriptor_; ++fd)
+      if (FD_ISSET(fd, &revents_[read_op]) || FD_ISSET(fd, &revents_[write_op]))
+        ready_fds_.push_back(fd);
+#endif
+  }
+
   enum
   {
     read_op,
@@ -97,6 +118,7 @@ protected:
   fd_set events_[max_ops];
   fd_set revents_[max_ops];
   int max_descriptor_ = 0;
+  yasio::pod_vector<socket_native_type> ready_fds_;
 
   select_interrupter interrupter_;
 };
@@ -55,6 +55,7 @@ SOFTWARE.
 #  endif
 typedef SOCKET socket_native_type;
 typedef int socklen_t;
+typedef WSABUF socket_iovec_type;
 #  define poll WSAPoll
 #  pragma comment(lib, "ws2_32.lib")
 
@@ -75,6 +76,7 @@ typedef int socklen_t;
 #  endif
 #  include <sys/select.h>
 #  include <sys/socket.h>
+#  include <sys/uio.h>
 #  include <sys/un.h>
 #  include <netinet/in.h>
 #  include <netinet/tcp.h>
@@ -96,6 +98,7 @@ typedef int socklen_t;
 #    define ioctlsocket ioctl
 #  endif
 typedef int socket_native_type;
+typedef struct iovec socket_iovec_type;
 #  undef socket
 #endif
 #define SD_NONE -1
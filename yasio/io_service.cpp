@@ -38,6 +38,34 @@ SOFTWARE.
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#if defined(_WIN32)
+#  include <io.h>
+#endif
+#if defined(__linux__)
+#  include <linux/filter.h>
+#  include <sys/sendfile.h>
+#  include <signal.h>
+#  include <netinet/udp.h>
+#  if !defined(UDP_SEGMENT)
+#    define UDP_SEGMENT 103
+#  endif
+#  if !defined(UDP_GRO)
+#    define UDP_GRO 104
+#  endif
+#  include <linux/errqueue.h>
+#  if !defined(SO_ZEROCOPY)
+#    define SO_ZEROCOPY 60
+#  endif
+#  if !defined(MSG_ZEROCOPY)
+#    define MSG_ZEROCOPY 0x4000000
+#  endif
+#  if !defined(SO_EE_ORIGIN_ZEROCOPY)
+#    define SO_EE_ORIGIN_ZEROCOPY 5
+#  endif
+#  if !defined(SO_EE_CODE_ZEROCOPY_COPIED)
+#    define SO_EE_CODE_ZEROCOPY_COPIED 1
+#  endif
+#endif
 #include "yasio/thread_name.hpp"
 
 #if defined(YASIO_SSL_BACKEND)
@@ -142,6 +170,115 @@ static const int yasio__max_wait_usec = 5 * 60 * 1000 * 1000LL;
 // the max transport alloc size
 static const size_t yasio__max_tsize = (std::max)({sizeof(io_transport_tcp), sizeof(io_transport_udp), sizeof(io_transport_ssl), sizeof(io_transport_kcp)});
 static const int yasio__udp_mss = static_cast<int>((std::numeric_limits<uint16_t>::max)() - (sizeof(yasio::ip::ip_hdr_st) + sizeof(yasio::ip::udp_hdr_st)));
+#if defined(SO_ATTACH_REUSEPORT_CBPF)
+// steer incoming connections of the SO_REUSEPORT group to the socket indexed by cpu % nsocks
+static int yasio__attach_reuseport_cbpf(xxsocket* s, int nsocks)
+{
+  struct sock_filter code[] = {
+      {BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_CPU)},
+      {BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<uint32_t>(nsocks)},
+      {BPF_RET | BPF_A, 0, 0, 0},
+  };
+  struct sock_fprog prog = {static_cast<unsigned short>(sizeof(code) / sizeof(code[0])), code};
+  return s->set_optval(SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, prog);
+}
+#endif
+#if YASIO__HAS_MMSG
+union yasio__udp_cmsg {
+  char buf[CMSG_SPACE(sizeof(int))];
+  struct cmsghdr align;
+};
+// attach UDP_SEGMENT cmsg to msg, the kernel splits the payload to datagrams of segment_size
+static void yasio__set_udp_segment(struct msghdr& msg, yasio__udp_cmsg& control, int segment_size)
+{
+  msg.msg_control    = control.buf;
+  msg.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+  auto cm            = CMSG_FIRSTHDR(&msg);
+  cm->cmsg_level     = SOL_UDP;
+  cm->cmsg_type      = UDP_SEGMENT;
+  cm->cmsg_len       = CMSG_LEN(sizeof(uint16_t));
+  *reinterpret_cast<uint16_t*>(CMSG_DATA(cm)) = static_cast<uint16_t>(segment_size);
+}
+// visit the received datagrams, the UDP_GRO coalesced one split by it's segment size, stop when func returns false
+template <typename _Fty>
+static bool yasio__visit_mmsg(struct mmsghdr* msgvec, int vlen, _Fty&& func)
+{
+  for (int i = 0; i < vlen; ++i)
+  {
+    auto& msg           = msgvec[i];
+    auto data           = static_cast<char*>(msg.msg_hdr.msg_iov->iov_base);
+    unsigned int len    = msg.msg_len;
+    unsigned int sgsize = len;
+    for (auto cm = CMSG_FIRSTHDR(&msg.msg_hdr); cm; cm = CMSG_NXTHDR(&msg.msg_hdr, cm))
+      if (cm->cmsg_level == SOL_UDP && cm->cmsg_type == UDP_GRO)
+        sgsize = static_cast<unsigned int>((std::max)(*reinterpret_cast<int*>(CMSG_DATA(cm)), 1));
+    unsigned int offset = 0;
+    do
+    {
+      if (!func(i, data + offset, static_cast<int>((std::min)(sgsize, len - offset))))
+        return false;
+    } while ((offset += sgsize) < len);
+  }
+  return true;
+}
+#endif
+// the max rounds of relay transfer per direction per event loop, see io_service::relay
+static const int yasio__max_relay_rounds = 16;
+#if YASIO__HAS_SENDFILE
+// the max bytes of one sendfile/splice call, same as linux MAX_RW_COUNT
+static const size_t yasio__max_sendfile_size = 0x7ffff000;
+// the sendfile/splice can't ignore SIGPIPE by MSG_NOSIGNAL, so block it at io thread, the
+// blocked SIGPIPE raised by them is thread-directed, it keeps pending and never delivered
+static void yasio__block_sigpipe()
+{
+  static thread_local bool blocked = false;
+  if (!blocked)
+  {
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGPIPE);
+    blocked = ::pthread_sigmask(SIG_BLOCK, &set, nullptr) == 0;
+  }
+}
+#endif
+// the size of regular file, -1: not regular file
+static int64_t yasio__file_size(int fd)
+{
+#if defined(_WIN32)
+  struct _stat64 st;
+  return (::_fstat64(fd, &st) == 0 && (st.st_mode & _S_IFMT) == _S_IFREG) ? static_cast<int64_t>(st.st_size) : -1;
+#else
+  struct stat st;
+  return (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) ? static_cast<int64_t>(st.st_size) : -1;
+#endif
+}
+// read file at offset
+static int yasio__file_read(int fd, void* buf, size_t len, int64_t offset)
+{
+#if defined(_WIN32)
+  if (::_lseeki64(fd, offset, SEEK_SET) < 0)
+    return -1;
+  return ::_read(fd, buf, static_cast<unsigned int>(len));
+#else
+  return static_cast<int>(::pread(fd, buf, len, static_cast<off_t>(offset)));
+#endif
+}
+static int yasio__file_open(const char* path)
+{
+#if defined(_WIN32)
+  return ::_open(path, _O_RDONLY | _O_BINARY);
+#else
+  return ::open(path, O_RDONLY | O_CLOEXEC);
+#endif
+}
+static void yasio__file_close(int fd)
+{
+#if defined(_WIN32)
+  ::_close(fd);
+#else
+  ::close(fd);
+#endif
+}
 } // namespace
 struct yasio__global_state {
   enum
@@ -199,14 +336,14 @@ static yasio__global_state& yasio__shared_globals(const print_fn2_t& prt = nullp
 /// highp_timer
 void highp_timer::async_wait(timer_cb_t cb) { service_.schedule_timer(this, std::move(cb)); }
 void highp_timer::cancel()
-{
-  if (!expired())
-    service_.remove_timer(this);
+{ // discard the schedules posted before, the timer expired may still queued or not fired yet
+  state_->generation_.fetch_add(1, std::memory_order_acq_rel);
+  service_.remove_timer(this);
 }
 
 std::chrono::microseconds highp_timer::wait_duration() const
 {
-  return std::chrono::duration_cast<std::chrono::microseconds>(this->expire_time_ - service_.current_time_);
+  return std::chrono::duration_cast<std::chrono::microseconds>(state_->expire_time_.load(std::memory_order_relaxed) - service_.current_time_);
 }
 
 /// io_send_op
@@ -218,6 +355,67 @@ int io_sendto_op::perform(io_transport* transport, const void* buf, int n, int&
   return transport->write_cb_(buf, n, std::addressof(destination_), error);
 }
 
+/// io_sendfile_op
+io_sendfile_op::io_sendfile_op(int fd, bool owns_fd, int64_t offset, size_t length, int mode, completion_cb_t&& handler)
+    : io_send_op(io_send_buffer{nullptr, 0}, std::move(handler)), fd_(fd), owns_fd_(owns_fd), mode_(mode), file_offset_(offset), length_(length), piped_(0),
+      chunk_offset_(0)
+{
+  pipe_[0] = pipe_[1] = -1;
+}
+io_sendfile_op::~io_sendfile_op()
+{
+  if (owns_fd_)
+    yasio__file_close(fd_);
+#if YASIO__HAS_SENDFILE
+  if (pipe_[0] != -1)
+  {
+    ::close(pipe_[0]);
+    ::close(pipe_[1]);
+  }
+#endif
+}
+
+/// io_relay_pipe
+io_relay_pipe::io_relay_pipe()
+{
+#if YASIO__HAS_SENDFILE
+  if (::pipe2(fds_, O_NONBLOCK | O_CLOEXEC) == -1)
+    fds_[0] = fds_[1] = -1;
+#endif
+}
+io_relay_pipe::~io_relay_pipe()
+{
+#if YASIO__HAS_SENDFILE
+  if (fds_[0] != -1)
+  {
+    ::close(fds_[0]);
+    ::close(fds_[1]);
+  }
+#endif
+}
+int io_relay_pipe::fill(xxsocket* s)
+{
+#if YASIO__HAS_SENDFILE
+  return static_cast<int>(::splice(s->native_handle(), nullptr, fds_[1], nullptr, yasio__max_rcvbuf, SPLICE_F_MOVE | SPLICE_F_NONBLOCK));
+#else
+  if (buffer_.empty())
+    buffer_.resize(yasio__max_rcvbuf);
+  offset_ = 0;
+  return s->recv(buffer_.data(), static_cast<int>(buffer_.size()), 0);
+#endif
+}
+int io_relay_pipe::flush(xxsocket* s)
+{
+#if YASIO__HAS_SENDFILE
+  return static_cast<int>(::splice(fds_[0], nullptr, s->native_handle(), nullptr, pending_, SPLICE_F_MOVE | SPLICE_F_NONBLOCK));
+#else
+  int n = s->send(buffer_.data() + offset_, static_cast<int>(pending_), YASIO_MSG_FLAG);
+  if (n > 0)
+    offset_ += n;
+  return n;
+#endif
+}
+
 /// io_channel
 io_channel::io_channel(io_service& service, int index) : io_base(), service_(service), timer_(service), user_timer_(service)
 {
@@ -370,11 +568,69 @@ const print_fn2_t& io_transport::__get_cprint() const { return ctx_->get_service
 int io_transport::write(io_send_buffer&& buffer, completion_cb_t&& handler)
 {
   int n = static_cast<int>(buffer.size());
-  send_queue_.emplace(cxx14::make_unique<io_send_op>(std::move(buffer), std::move(handler)));
-  get_service().wakeup();
+  enqueue(make_send_op(std::move(buffer), std::move(handler)));
   return n;
 }
-int io_transport::do_read(int revent, int& error, highp_time_t&) { return this->call_read(buffer_ + offset_, sizeof(buffer_) - offset_, revent, error); }
+send_op_ptr io_transport::make_send_op(io_send_buffer&& buffer, completion_cb_t&& handler)
+{
+  return cxx14::make_unique<io_send_op>(std::move(buffer), std::move(handler));
+}
+void io_transport::enqueue(send_op_ptr&& op, bool wakeup)
+{
+  if (send_high_mark_ > 0)
+    queued_bytes_ += static_cast<int64_t>(op->size());
+  send_queue_.emplace(std::move(op));
+  get_service().notify_transport(this);
+  if (wakeup)
+    get_service().wakeup();
+}
+int io_transport::do_read(int revent, int& error, highp_time_t&)
+{
+  if (rbuf_)
+  { // prepare first, the non-mirrored ring may compact and move the tail
+    int space = static_cast<int>((std::min)(rbuf_->prepare(), static_cast<size_t>(INT_MAX)));
+    return this->call_read(rbuf_->tail(), space, revent, error);
+  }
+  if (!revent) // don't borrow recv buffer when not readable
+    return this->call_read(nullptr, 0, revent, error);
+  auto buf = borrow_buffer();
+  return this->call_read(buf + offset_, yasio__max_rcvbuf - offset_, revent, error);
+}
+char* io_transport::borrow_buffer()
+{
+  const int full_class = recv_buffer_pool::max_classes - 1;
+  if (buffer_class_ != full_class)
+  {
+    auto& pool = get_service().rbuf_pool_;
+    auto buf   = pool.acquire(full_class);
+    if (buffer_)
+    {
+      ::memcpy(buf, buffer_, offset_);
+      pool.release(buffer_, buffer_class_);
+    }
+    buffer_       = buf;
+    buffer_class_ = full_class;
+  }
+  return buffer_;
+}
+void io_transport::return_buffer()
+{
+  if (!buffer_)
+    return;
+  int cls = offset_ > 0 ? recv_buffer_pool::class_of(offset_) : -1;
+  if (cls == buffer_class_)
+    return;
+  auto& pool = get_service().rbuf_pool_;
+  char* buf  = nullptr;
+  if (cls != -1)
+  {
+    buf = pool.acquire(cls);
+    ::memcpy(buf, buffer_, offset_);
+  }
+  pool.release(buffer_, buffer_class_);
+  buffer_       = buf;
+  buffer_class_ = cls;
+}
 bool io_transport::do_write(highp_time_t& wait_duration)
 {
   bool ret = false;
@@ -384,15 +640,35 @@ bool io_transport::do_write(highp_time_t& wait_duration)
       break;
 
     int error = 0;
-    auto wrap = send_queue_.peek();
-    if (wrap)
+    int n     = 0;
+    if (yasio__testbits(ctx_->properties_, YCM_TCP))
     {
-      auto& v = *wrap;
-      if (call_write(v.get(), error) < 0)
-      {
-        this->set_last_errno(error, yasio::io_base::error_stage::WRITE);
-        break;
-      }
+      auto wrap = send_queue_.peek();
+      if (wrap && (*wrap)->is_file())
+        n = call_sendfile(static_cast<io_sendfile_op*>((*wrap).get()), error);
+      else if (yasio__testbits(ctx_->properties_, YCM_SSL))
+        n = wrap ? call_write((*wrap).get(), error) : 0;
+#if YASIO__HAS_ZEROCOPY
+      else if (wrap && zc_threshold_ > 0 && static_cast<int>((*wrap)->buffer_.size() - (*wrap)->offset_) >= zc_threshold_)
+        n = call_write_zerocopy((*wrap).get(), error);
+#endif
+      else
+        n = call_writev(error);
+    }
+#if YASIO__HAS_MMSG
+    else if ((get_service().options_.udp_batch_ > 1 || yasio__testbits(ctx_->properties_, YCF_UDP_GSO)) && !yasio__testbits(ctx_->properties_, YCM_KCP))
+      n = call_sendmmsg(error);
+#endif
+    else
+    {
+      auto wrap = send_queue_.peek();
+      if (wrap)
+        n = call_write((*wrap).get(), error);
+    }
+    if (n < 0)
+    {
+      this->set_last_errno(error, yasio::io_base::error_stage::WRITE);
+      break;
     }
 
     bool no_wevent = send_queue_.empty();
@@ -464,9 +740,375 @@ int io_transport::call_write(io_send_op* op, int& error)
   }
   return n;
 }
+int io_transport::call_writev(int& error)
+{
+  socket_iovec_type iov[YASIO_MAX_SEND_IOVCNT];
+  io_send_op* ops[YASIO_MAX_SEND_IOVCNT];
+  int iovcnt   = 0;
+  bool stopped = false;
+  auto lck     = send_queue_.peek_n(YASIO_MAX_SEND_IOVCNT, [&](send_op_ptr& op) {
+    auto len = op->buffer_.size() - op->offset_;
+    // the file op will be sent by call_sendfile when it becomes the front one
+    stopped = stopped || op->is_file();
+#if YASIO__HAS_ZEROCOPY
+    // the large op will be sent with MSG_ZEROCOPY when it becomes the front one
+    stopped = stopped || (zc_threshold_ > 0 && len >= static_cast<size_t>(zc_threshold_));
+#endif
+    if (stopped)
+      return;
+    ops[iovcnt] = op.get();
+    xxsocket::set_iovec(iov[iovcnt], op->buffer_.data() + op->offset_, len);
+    ++iovcnt;
+  });
+  if (iovcnt <= 1)
+    return iovcnt == 1 ? call_write(ops[0], error) : 0;
+
+  int n = socket_->sendv(iov, iovcnt, YASIO_MSG_FLAG);
+  if (n > 0)
+  { // complete the fully sent ops in order, the partial sent op remain data will be send at next frame.
+    size_t bytes_transferred = n;
+    for (int i = 0; i < iovcnt && bytes_transferred > 0; ++i)
+    {
+      auto op   = ops[i];
+      auto left = op->buffer_.size() - op->offset_;
+      if (bytes_transferred < left)
+      {
+        op->offset_ += bytes_transferred;
+        break;
+      }
+      op->offset_ += left;
+      bytes_transferred -= left;
+      this->complete_op(op, 0);
+    }
+  }
+  else if (n < 0)
+  {
+    error = xxsocket::get_last_errno();
+    if (xxsocket::not_send_error(error))
+      n = 0;
+  }
+  return n;
+}
+int io_transport::call_sendfile(io_sendfile_op* op, int& error)
+{
+  int n       = 0;
+  bool eof    = false;
+  auto remain = op->length_ - op->offset_;
+  if (remain == 0)
+  {
+    this->complete_op(op, 0);
+    return 0;
+  }
+#if YASIO__HAS_SENDFILE
+  if (op->mode_ != io_sendfile_op::mode_read)
+    yasio__block_sigpipe();
+  if (op->mode_ == io_sendfile_op::mode_sendfile)
+  {
+    off_t offset = static_cast<off_t>(op->file_offset_ + op->offset_);
+    auto ret     = ::sendfile(socket_->native_handle(), op->fd_, &offset, (std::min)(remain, yasio__max_sendfile_size));
+    if (ret > 0)
+      n = static_cast<int>(ret);
+    else if (ret == 0)
+      eof = true;
+    else
+    {
+      error = errno;
+      if (error == EINVAL || error == ENOSYS || error == EOPNOTSUPP)
+      { // the filesystem doesn't support sendfile
+        op->mode_ = io_sendfile_op::mode_splice;
+        return call_sendfile(op, error = 0);
+      }
+      n = -1;
+    }
+  }
+  else if (op->mode_ == io_sendfile_op::mode_splice)
+  {
+    if (op->pipe_[0] == -1 && ::pipe2(op->pipe_, O_NONBLOCK | O_CLOEXEC) == -1)
+    {
+      error = errno;
+      this->complete_op(op, error);
+      return 0;
+    }
+    if (op->piped_ < remain)
+    { // fill the pipe as much as possible, the file pages are moved without copy
+      loff_t offset = static_cast<loff_t>(op->file_offset_ + op->offset_ + op->piped_);
+      auto ret = ::splice(op->fd_, &offset, op->pipe_[1], nullptr, (std::min)(remain - op->piped_, yasio__max_sendfile_size), SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+      if (ret > 0)
+        op->piped_ += static_cast<size_t>(ret);
+      else if (ret == 0)
+        eof = op->piped_ == 0;
+      else if (errno != EAGAIN && op->piped_ == 0)
+      { // pipe full when EAGAIN, otherwise the file can't be spliced, fallback to read
+        if (errno == EINVAL || errno == ENOSYS)
+        {
+          op->mode_ = io_sendfile_op::mode_read;
+          return call_sendfile(op, error);
+        }
+        error = errno;
+        this->complete_op(op, error);
+        return 0;
+      }
+    }
+    if (op->piped_ > 0)
+    {
+      auto ret = ::splice(op->pipe_[0], nullptr, socket_->native_handle(), nullptr, op->piped_, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+      if (ret >= 0)
+      {
+        n = static_cast<int>(ret);
+        op->piped_ -= static_cast<size_t>(ret);
+      }
+      else
+      {
+        error = errno;
+        n     = -1;
+      }
+    }
+  }
+  else
+#endif
+  {
+    if (op->chunk_offset_ == op->chunk_.size())
+    { // read next chunk, the remain data of current chunk must be sent first, it's required by ssl write retry
+      op->chunk_.resize((std::min)(remain, static_cast<size_t>(YASIO_SENDFILE_CHUNK_SIZE)));
+      int ret = yasio__file_read(op->fd_, op->chunk_.data(), op->chunk_.size(), op->file_offset_ + op->offset_);
+      if (ret < 0)
+      {
+        error = errno;
+        op->chunk_.clear();
+        this->complete_op(op, error);
+        return 0;
+      }
+      op->chunk_.resize(ret);
+      op->chunk_offset_ = 0;
+      eof               = ret == 0;
+    }
+    if (!eof)
+    {
+      n = write_cb_(op->chunk_.data() + op->chunk_offset_, static_cast<int>(op->chunk_.size() - op->chunk_offset_), nullptr, error);
+      if (n > 0)
+        op->chunk_offset_ += n;
+    }
+  }
+
+  if (n > 0)
+  {
+    op->offset_ += n;
+    if (op->offset_ == op->length_)
+      this->complete_op(op, 0);
+  }
+  else if (eof) // the file truncated
+    this->complete_op(op, yasio::errc::eof);
+  else if (n < 0)
+  {
+    if (xxsocket::not_send_error(error))
+      n = 0;
+  }
+  return n;
+}
+#if YASIO__HAS_ZEROCOPY
+int io_transport::call_write_zerocopy(io_send_op* op, int& error)
+{
+  int n = socket_->send(op->buffer_.data() + op->offset_, static_cast<int>(op->buffer_.size() - op->offset_), YASIO_MSG_FLAG | MSG_ZEROCOPY);
+  if (n > 0)
+  { // every successful send consumes one seq of zero-copy completion
+    ++zc_next_;
+    op->offset_ += n;
+    if (op->offset_ == op->buffer_.size())
+      this->complete_op(op, 0);
+  }
+  else if (n < 0)
+  {
+    error = xxsocket::get_last_errno();
+    if (error == ENOBUFS) // exceed the optmem limit of pinned pages, send with copy
+      return call_write(op, error = 0);
+    if (xxsocket::not_send_error(error))
+      n = 0;
+  }
+  return n;
+}
+void io_transport::reap_zerocopy()
+{
+  union {
+    char buf[CMSG_SPACE(sizeof(struct sock_extended_err) + sizeof(struct sockaddr_in6))];
+    struct cmsghdr align;
+  } control;
+  for (;;)
+  {
+    struct msghdr msg;
+    ::memset(&msg, 0, sizeof(msg));
+    msg.msg_control    = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    if (::recvmsg(socket_->native_handle(), &msg, MSG_ERRQUEUE) < 0)
+      break;
+    for (auto cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm))
+    {
+      if (!(cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) && !(cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR))
+        continue;
+      auto serr = reinterpret_cast<const struct sock_extended_err*>(CMSG_DATA(cm));
+      if (serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY || serr->ee_errno != 0)
+        continue;
+      if (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)
+        zc_threshold_ = 0; // the kernel copied data, i.e. loopback device, zero-copy is pure overhead
+
+      // the completed seq range [ee_info, ee_data], usually in order, but not guaranteed
+      uint32_t lo = serr->ee_info, hi = serr->ee_data + 1;
+      if (lo == zc_done_)
+        zc_done_ = hi;
+      else
+        zc_ranges_.push_back(std::make_pair(lo, hi));
+      for (auto it = zc_ranges_.begin(); it != zc_ranges_.end();)
+      {
+        if (it->first == zc_done_)
+        {
+          zc_done_ = it->second;
+          zc_ranges_.erase(it);
+          it = zc_ranges_.begin();
+        }
+        else
+          ++it;
+      }
+    }
+  }
+
+  while (!zc_ops_.empty() && static_cast<int32_t>(zc_done_ - zc_ops_.front().seq) >= 0)
+  {
+    auto item = std::move(zc_ops_.front());
+    zc_ops_.pop_front();
+    YASIO_KLOGV("[index: %d] zero-copy write complete, bytes transferred: %d", this->cindex(), static_cast<int>(item.op->offset_));
+    if (item.op->handler_)
+      item.op->handler_(item.error, item.op->offset_);
+  }
+}
+void io_transport::abort_zerocopy(int error)
+{
+  if (!zerocopy_pending())
+    return;
+  reap_zerocopy(); // the completions already queued release the ops normally
+  while (!zc_ops_.empty())
+  {
+    auto item = std::move(zc_ops_.front());
+    zc_ops_.pop_front();
+    if (item.op->handler_)
+      item.op->handler_(item.error != 0 ? item.error : error, item.op->offset_);
+  }
+}
+#endif
+#if YASIO__HAS_MMSG
+int io_transport::call_sendmmsg(int& error)
+{
+  struct mmsghdr msgvec[YASIO_MAX_UDP_BATCH];
+  struct iovec iov[YASIO_MAX_UDP_BATCH];
+  io_send_op* ops[YASIO_MAX_UDP_BATCH];
+  const ip::endpoint* destinations[YASIO_MAX_UDP_BATCH];
+  int segments[YASIO_MAX_UDP_BATCH]; // the datagrams count of each message
+  yasio__udp_cmsg controls[YASIO_MAX_UDP_BATCH];
+  const bool gso        = !gso_off_ && yasio__testbits(ctx_->properties_, YCF_UDP_GSO);
+  const unsigned int nmax = static_cast<unsigned int>(get_service().options_.udp_batch_);
+  unsigned int vlen     = 0;
+  int nops              = 0;
+  size_t segment_size   = 0, message_size = 0;
+  bool stopped          = false;
+  auto lck              = send_queue_.peek_n(gso ? YASIO_MAX_UDP_BATCH : nmax, [&](send_op_ptr& op) {
+    if (stopped)
+      return;
+    auto len         = op->buffer_.size() - op->offset_;
+    auto destination = op->destination();
+    xxsocket::set_iovec(iov[nops], op->buffer_.data() + op->offset_, (std::min)(len, static_cast<size_t>(yasio__udp_mss)));
+    if (gso && vlen > 0)
+    { // merge to previous message: same destination, and only the last datagram can be smaller than segment size
+      const auto prev = destinations[vlen - 1];
+      if (segment_size > 0 && len > 0 && len <= segment_size && message_size % segment_size == 0 && message_size + len <= static_cast<size_t>(yasio__udp_mss) &&
+          segments[vlen - 1] < YASIO_MAX_GSO_SEGMENTS && (prev == destination || (prev && destination && *prev == *destination)))
+      {
+        ++msgvec[vlen - 1].msg_hdr.msg_iovlen;
+        ++segments[vlen - 1];
+        message_size += len;
+        ops[nops++] = op.get();
+        return;
+      }
+    }
+    if (vlen == nmax)
+    {
+      stopped = true;
+      return;
+    }
+    // the op larger than udp mss will be sent by multi datagrams, so it must be the last one of batch
+    stopped = len > static_cast<size_t>(yasio__udp_mss);
+
+    auto& msg = msgvec[vlen];
+    ::memset(&msg, 0, sizeof(msg));
+    msg.msg_hdr.msg_name    = const_cast<ip::endpoint*>(destination);
+    msg.msg_hdr.msg_namelen = destination ? destination->len() : 0;
+    msg.msg_hdr.msg_iov     = &iov[nops];
+    msg.msg_hdr.msg_iovlen  = 1;
+    destinations[vlen]      = destination;
+    segments[vlen++]        = 1;
+    segment_size = message_size = iov[nops].iov_len;
+    ops[nops++]                 = op.get();
+  });
+  if (nops <= 1)
+    return nops == 1 ? call_write(ops[0], error) : 0;
+
+  for (unsigned int i = 0; i < vlen; ++i)
+    if (segments[i] > 1)
+      yasio__set_udp_segment(msgvec[i].msg_hdr, controls[i], static_cast<int>(msgvec[i].msg_hdr.msg_iov->iov_len));
+
+  int n = socket_->sendmmsg(msgvec, vlen, YASIO_MSG_FLAG);
+  if (n > 0)
+  {
+    for (int i = 0, k = 0; i < n; ++i)
+    {
+      if (segments[i] == 1)
+      {
+        auto op = ops[k++];
+        op->offset_ += msgvec[i].msg_len;
+        if (op->offset_ == op->buffer_.size())
+          this->complete_op(op, 0);
+      }
+      else
+      { // the UDP_SEGMENT message is sent entirely or failed
+        for (int j = 0; j < segments[i]; ++j)
+        {
+          auto op     = ops[k++];
+          op->offset_ = op->buffer_.size();
+          this->complete_op(op, 0);
+        }
+      }
+    }
+  }
+  else if (n < 0)
+  {
+    error = xxsocket::get_last_errno();
+    n     = 0;
+    if (segments[0] > 1 && (error == EIO || error == EINVAL))
+    { // the route device doesn't support checksum offload or the segment exceed path mtu, resend them without GSO
+      YASIO_KLOGW("[index: %d] send udp segments failed, ec=%d, detail:%s, disable GSO", this->cindex(), error, io_service::strerror(error));
+      gso_off_ = true;
+      error    = 0;
+    }
+    else if (!xxsocket::not_send_error(error))
+    { // same as call_write, simply drop the datagrams failed to send
+      for (int j = 0; j < segments[0]; ++j)
+        this->complete_op(ops[j], error);
+    }
+  }
+  return n;
+}
+#endif
 void io_transport::complete_op(io_send_op* op, int error)
 {
   YASIO_KLOGV("[index: %d] write complete, bytes transferred: %d/%d", this->cindex(), static_cast<int>(op->offset_), static_cast<int>(op->buffer_.size()));
+  if (send_high_mark_ > 0)
+    queued_bytes_ -= static_cast<int64_t>(op->size());
+#if YASIO__HAS_ZEROCOPY
+  if (zerocopy_pending())
+  { // the op referenced by kernel until zero-copy completion, or the previous ops not released, keep completion order
+    auto wrap = send_queue_.peek();
+    zc_ops_.push_back(zerocopy_op{std::move(*wrap), zc_next_, error});
+    send_queue_.pop();
+    return;
+  }
+#endif
   if (op->handler_)
     op->handler_(error, op->offset_);
   send_queue_.pop();
@@ -615,19 +1257,25 @@ void io_transport_udp::disconnect()
   connected_ = false;
   set_primitives();
 }
-int io_transport_udp::write(io_send_buffer&& buffer, completion_cb_t&& handler)
+send_op_ptr io_transport_udp::make_send_op(io_send_buffer&& buffer, completion_cb_t&& handler)
 {
-  return connected_ ? io_transport::write(std::move(buffer), std::move(handler)) : write_to(std::move(buffer), ensure_destination(), std::move(handler));
+  if (connected_)
+    return io_transport::make_send_op(std::move(buffer), std::move(handler));
+  return cxx14::make_unique<io_sendto_op>(std::move(buffer), std::move(handler), ensure_destination());
 }
 int io_transport_udp::write_to(io_send_buffer&& buffer, const ip::endpoint& to, completion_cb_t&& handler)
 {
   int n = static_cast<int>(buffer.size());
-  send_queue_.emplace(cxx14::make_unique<io_sendto_op>(std::move(buffer), std::move(handler), to));
-  get_service().wakeup();
+  enqueue(cxx14::make_unique<io_sendto_op>(std::move(buffer), std::move(handler), to));
   return n;
 }
 void io_transport_udp::set_primitives()
 {
+#if YASIO__HAS_MMSG
+  // only connected udp transports and kcp transports can handle the coalesced datagrams
+  if (yasio__testbits(ctx_->properties_, YCF_UDP_GRO))
+    socket_->set_optval(SOL_UDP, UDP_GRO, static_cast<int>(connected_ || yasio__testbits(ctx_->properties_, YCM_KCP)));
+#endif
   if (connected_)
     io_transport::set_primitives();
   else
@@ -681,9 +1329,12 @@ io_transport_kcp::io_transport_kcp(io_channel* ctx, xxsocket_ptr&& s) : io_trans
   // Because of nodelaying config will change the value. so setting RTO min after call ikcp_nodely.
   this->kcp_->rx_minrto = kopts.kcp_minrto_;
 
-  this->rawbuf_.resize(yasio__max_rcvbuf);
   ::ikcp_setoutput(this->kcp_, [](const char* buf, int len, ::ikcpcb* /*kcp*/, void* user) {
-    auto t         = (io_transport_kcp*)user;
+    auto t = (io_transport_kcp*)user;
+#  if YASIO__HAS_MMSG
+    if (yasio__testbits(t->ctx_->properties_, YCF_UDP_GSO) && !t->gso_off_)
+      return t->gso_output(buf, len);
+#  endif
     int ignored_ec = 0;
     return t->underlaying_write_cb_(buf, len, std::addressof(t->ensure_destination()), ignored_ec);
   });
@@ -699,6 +1350,9 @@ void io_transport_kcp::set_primitives()
     if (nsent > 0)
     {
       ::ikcp_flush(kcp_);
+#  if YASIO__HAS_MMSG
+      gso_flush();
+#  endif
       expire_time_ = 0;
     }
     else
@@ -714,6 +1368,9 @@ bool io_transport_kcp::do_write(highp_time_t& wait_duration)
   if (((IINT32)(current - expire_time_)) >= 0)
   {
     ::ikcp_update(kcp_, current);
+#  if YASIO__HAS_MMSG
+    gso_flush();
+#  endif
     expire_time_ = ::ikcp_check(kcp_, current);
   }
 
@@ -721,16 +1378,31 @@ bool io_transport_kcp::do_write(highp_time_t& wait_duration)
 }
 int io_transport_kcp::do_read(int revent, int& error, highp_time_t& wait_duration)
 {
-  int n = this->call_read(&rawbuf_.front(), static_cast<int>(rawbuf_.size()), revent, error);
-  if (n > 0)
-    this->handle_input(rawbuf_.data(), n, error, wait_duration);
+  int n;
+  if (revent)
+  { // the low level raw buffer, lent by io_service only for this read
+    auto& pool     = get_service().rbuf_pool_;
+    const int full = recv_buffer_pool::max_classes - 1;
+    auto rawbuf    = pool.acquire(full);
+    n              = this->call_read(rawbuf, yasio__max_rcvbuf, revent, error);
+    if (n > 0)
+      this->handle_input(rawbuf, n, error, wait_duration);
+    pool.release(rawbuf, full);
+  }
+  else
+    n = this->call_read(nullptr, 0, revent, error);
   if (!error)
   { // !important, should always try to call ikcp_recv when no error occured.
-    n = ::ikcp_recv(kcp_, buffer_ + offset_, sizeof(buffer_) - offset_);
-    if (n > 0) // If got data from kcp, don't wait
-      wait_duration = 0;
-    else if (n < 0)
-      n = 0; // EAGAIN/EWOULDBLOCK
+    n = 0;
+    if (::ikcp_peeksize(kcp_) > 0)
+    { // borrow recv buffer only when a message is ready
+      auto buf = borrow_buffer();
+      n        = ::ikcp_recv(kcp_, buf + offset_, yasio__max_rcvbuf - offset_);
+      if (n > 0) // If got data from kcp, don't wait
+        wait_duration = 0;
+      else if (n < 0)
+        n = 0; // EAGAIN/EWOULDBLOCK
+    }
   }
   return n;
 }
@@ -746,6 +1418,57 @@ int io_transport_kcp::handle_input(char* buf, int len, int& error, highp_time_t&
   error = yasio::errc::invalid_packet;
   return -1;
 }
+#  if YASIO__HAS_MMSG
+int io_transport_kcp::gso_output(const char* buf, int len)
+{
+  // only the last datagram of UDP_SEGMENT message can be smaller than segment size
+  const int size = static_cast<int>(gso_buffer_.size());
+  if (size > 0 && (len > gso_size_ || size % gso_size_ != 0 || size + len > yasio__udp_mss || size / gso_size_ >= YASIO_MAX_GSO_SEGMENTS))
+    gso_flush();
+  if (gso_buffer_.empty())
+    gso_size_ = len;
+  gso_buffer_.insert(gso_buffer_.end(), buf, buf + len);
+  return len;
+}
+void io_transport_kcp::gso_flush()
+{
+  const int size = static_cast<int>(gso_buffer_.size());
+  if (size == 0)
+    return;
+  if (size > gso_size_)
+  {
+    struct mmsghdr msg;
+    struct iovec iov;
+    yasio__udp_cmsg control;
+    ::memset(&msg, 0, sizeof(msg));
+    xxsocket::set_iovec(iov, gso_buffer_.data(), gso_buffer_.size());
+    if (!connected_)
+    {
+      auto& destination       = ensure_destination();
+      msg.msg_hdr.msg_name    = const_cast<ip::endpoint*>(std::addressof(destination));
+      msg.msg_hdr.msg_namelen = destination.len();
+    }
+    msg.msg_hdr.msg_iov    = &iov;
+    msg.msg_hdr.msg_iovlen = 1;
+    yasio__set_udp_segment(msg.msg_hdr, control, gso_size_);
+    int error = 0;
+    if (socket_->sendmmsg(&msg, 1, YASIO_MSG_FLAG) < 0 && ((error = xxsocket::get_last_errno()) == EIO || error == EINVAL))
+    { // fallback to send one by one
+      YASIO_KLOGW("[index: %d] send udp segments failed, ec=%d, detail:%s, disable GSO", this->cindex(), error, io_service::strerror(error));
+      gso_off_ = true;
+    }
+    else
+    { // the lost datagrams will be retransmitted by kcp
+      gso_buffer_.clear();
+      return;
+    }
+  }
+  int ignored_ec = 0;
+  for (int offset = 0; offset < size; offset += gso_size_)
+    underlaying_write_cb_(gso_buffer_.data() + offset, (std::min)(gso_size_, size - offset), std::addressof(ensure_destination()), ignored_ec);
+  gso_buffer_.clear();
+}
+#  endif
 #endif
 // ------------------------ io_service ------------------------
 void io_service::init_globals(const yasio::inet::print_fn2_t& prt) { yasio__shared_globals(prt).cprint_ = prt; }
@@ -775,6 +1498,8 @@ void io_service::start(event_cb_t cb)
     if (cb)
       options_.on_event_ = std::move(cb);
     this->state_ = io_service::state::RUNNING;
+    start_dispatchers();
+    start_loops();
     if (!options_.no_new_thread_)
     {
       this->worker_    = std::thread(&io_service::run, this);
@@ -824,10 +1549,16 @@ void io_service::handle_stop()
   if (this->state_ != state::AT_EXITING)
     return;
 
+  // stop worker loops first, let their close events dispatched by us
+  for (auto loop : loops_)
+    loop->stop();
   if (this->options_.deferred_event_ && !this->events_.empty())
     this->dispatch((std::numeric_limits<int>::max)());
   clear_transports();
-  this->timer_queue_.clear();
+  stop_loops();
+  process_commands();
+  clear_timers();
+  dispatch_pool_.stop();
   this->stop_flag_ = 0;
   this->worker_id_ = std::thread::id{};
   this->state_     = io_service::state::IDLE;
@@ -865,8 +1596,9 @@ void io_service::finalize()
 #endif
     destroy_channels();
 
-    options_.on_event_ = nullptr;
-    options_.resolv_   = nullptr;
+    options_.on_event_       = nullptr;
+    options_.on_batch_event_ = nullptr;
+    options_.resolv_         = nullptr;
 
     for (auto o : tpool_)
       ::operator delete(o);
@@ -899,8 +1631,19 @@ void io_service::destroy_channels()
 void io_service::clear_transports()
 {
   transport_map_.clear();
+  fd_transports_.clear();
+  ready_transports_.clear();
+  busy_transports_.clear();
+  paused_transports_.clear();
+  groups_.clear();
+  pending_transports_mtx_.lock();
+  pending_transports_.clear();
+  pending_transports_mtx_.unlock();
   for (auto transport : transports_)
   {
+#if YASIO__HAS_ZEROCOPY
+    transport->abort_zerocopy(yasio::errc::shutdown_by_localhost);
+#endif
     cleanup_io(transport);
     yasio::invoke_dtor(transport);
     this->tpool_.push_back(transport);
@@ -909,10 +1652,104 @@ void io_service::clear_transports()
 }
 size_t io_service::dispatch(int max_count)
 {
-  if (options_.on_event_)
-    this->events_.consume(max_count, options_.on_event_);
+  if (options_.on_batch_event_)
+  {
+    this->events_.consume(max_count, [this](event_ptr&& event) { dispatch_batch_.push_back(std::move(event)); });
+    if (!dispatch_batch_.empty())
+    {
+      int64_t weight = 0;
+      if (options_.event_high_mark_ > 0)
+        for (auto& event : dispatch_batch_)
+          weight += event_weight(event.get());
+      options_.on_batch_event_(dispatch_batch_.data(), dispatch_batch_.size());
+      dispatch_batch_.clear();
+      if (options_.event_high_mark_ > 0)
+        untrack_events(weight);
+    }
+  }
+  else if (options_.on_event_)
+  {
+    if (options_.event_high_mark_ > 0)
+    { // the weight must be taken before callback, the packet may be moved out
+      int64_t weight = 0;
+      this->events_.consume(max_count, [this, &weight](event_ptr&& event) {
+        weight += event_weight(event.get());
+        options_.on_event_(std::move(event));
+      });
+      untrack_events(weight);
+    }
+    else
+      this->events_.consume(max_count, options_.on_event_);
+  }
   return this->events_.count();
 }
+void io_service::untrack_events(int64_t weight)
+{
+  auto queued = (queued_weight_ -= weight);
+  // wakeup the loops which paused transports to resume reading, see io_service::unthrottle_reads
+  if (queued <= options_.event_low_mark_ && backpressure_.load() && backpressure_.exchange(false))
+  {
+    this->wakeup();
+    for (auto loop : loops_)
+      loop->wakeup();
+  }
+}
+void io_service::throttle_read(transport_handle_t transport)
+{
+  YASIO_KLOGV("[index: %d] the connection #%u read paused by event queue backpressure", transport->cindex(), transport->id_);
+  set_read_paused(transport, io_transport::READ_PAUSED_BY_BACKPRESSURE, true);
+  transport->paused_slot_ = paused_transports_.size();
+  paused_transports_.push_back(transport);
+}
+void io_service::unthrottle_reads()
+{
+  auto owner = event_owner();
+  // set before check, so either we see the queued events dropped, or the dispatcher see the flag and wakeup us
+  owner->backpressure_ = true;
+  if (owner->queued_weight_ > owner->options_.event_low_mark_)
+    return;
+  for (auto transport : paused_transports_)
+    if (transport) // nullptr: closed, see io_service::handle_close
+      set_read_paused(transport, io_transport::READ_PAUSED_BY_BACKPRESSURE, false);
+  paused_transports_.clear();
+}
+bool io_service::read_pausable(transport_handle_t transport) const
+{
+  auto props = transport->ctx_->properties_;
+  if (yasio__testbits(props, YCM_TCP))
+    return true;
+  // the udp server sessions routed by user receive datagrams from the server socket, see io_service::do_dgram_accept
+  return yasio__testbits(props, YCM_CLIENT) || (YASIO__UDP_KROUTE && !yasio__testbits(props, YCPF_MCAST));
+}
+void io_service::set_read_paused(transport_handle_t transport, uint8_t reason, bool paused)
+{
+  uint8_t prev            = transport->read_paused_;
+  transport->read_paused_ = paused ? static_cast<uint8_t>(prev | reason) : static_cast<uint8_t>(prev & ~reason);
+  // only the first pause and the last resume change the watcher interest
+  if (!prev != !transport->read_paused_)
+  {
+    if (paused)
+      io_watcher_.mod_event(transport->socket_->native_handle(), 0, socket_event::read);
+    else
+      io_watcher_.mod_event(transport->socket_->native_handle(), socket_event::read, 0);
+  }
+}
+void io_service::check_send_watermarks(transport_handle_t transport)
+{
+  auto queued = transport->queued_bytes_.load(std::memory_order_relaxed);
+  if (!transport->send_above_high_)
+  {
+    if (queued < transport->send_high_mark_)
+      return;
+    transport->send_above_high_ = true;
+    fire_event(transport->cindex(), YEK_ON_SEND_HIGH, static_cast<int>((std::min)(queued, static_cast<int64_t>((std::numeric_limits<int>::max)()))), transport);
+  }
+  else if (queued <= transport->send_low_mark_)
+  {
+    transport->send_above_high_ = false;
+    fire_event(transport->cindex(), YEK_ON_SEND_LOW, static_cast<int>(queued), transport);
+  }
+}
 
 #if defined(_WIN32)
 template <typename _Ty>
@@ -953,6 +1790,12 @@ void io_service::run()
   ares_socket_t ares_socks[ARES_GETSOCK_MAXNUM] = {0};
 #endif
 
+  // the interrupter may drained by previous run, a redundant wakeup is harmless but a missing one isn't
+  wakeup_pending_ = false;
+
+  // apply the commands posted when the service not running
+  process_commands();
+
   do
   {
     this->current_time_ = yasio::steady_clock_t::now();
@@ -973,6 +1816,8 @@ void io_service::run()
     {
       YASIO_KLOGV("[core] poll_io max_nfds=%d, waiting... %.3f milliseconds", io_watcher_.max_descriptor(), waitd_usec / static_cast<float>(std::milli::den));
       int retval = io_watcher_.poll_io(waitd_usec);
+      // the interrupter drained by poll_io, the producers after this point need wakeup again
+      wakeup_pending_.exchange(false, std::memory_order_acq_rel);
       YASIO_KLOGV("[core] poll_io waked up, retval=%d", retval);
       if (retval < 0)
       {
@@ -989,6 +1834,13 @@ void io_service::run()
     do_ares_process_fds(ares_socks, ares_nfds);
 #endif
 
+    // apply the commands posted by other threads, i.e. schedule timer, open channel
+    process_commands();
+
+    // process connections handoff from host service
+    if (this->host_)
+      process_handoffs();
+
     // process active transports
     process_transports();
 
@@ -1001,6 +1853,10 @@ void io_service::run()
     // process deferred events if auto dispatch enabled
     process_deferred_events();
 
+    // resume the transports paused by event queue backpressure
+    if (!paused_transports_.empty())
+      unthrottle_reads();
+
   } while (!this->stop_flag_ || !this->transports_.empty());
 
 #if defined(YASIO_USE_CARES)
@@ -1015,25 +1871,281 @@ void io_service::run()
 }
 void io_service::process_transports()
 {
-  // preform transports
-  for (auto iter = transports_.begin(); iter != transports_.end();)
+  if (options_.ready_list_)
   {
-    auto transport = *iter;
-    bool ok        = (do_read(transport) && do_write(transport));
-    if (ok)
+    collect_ready_transports();
+    // the open/close/stop operations of channel affect all it's transports, fallback to visit all
+    if (!this->stop_flag_ && !has_channel_opmask())
     {
-      int opm = transport->opmask_ | transport->ctx_->opmask_ | this->stop_flag_;
-      if (0 == opm)
-      { // no open/close/stop operations request
-        ++iter;
+      for (auto transport : ready_transports_)
+      {
+        if (process_transport(transport))
+          continue;
+        handle_close(transport);
+        remove_transport(transport);
+      }
+      return;
+    }
+  }
+
+  // preform transports, the removed one swapped with the last, so visit the same slot again
+  for (size_t i = 0; i < transports_.size();)
+  {
+    auto transport = transports_[i];
+    if (process_transport(transport))
+    {
+      ++i;
+      continue;
+    }
+    handle_close(transport);
+    remove_transport(transport);
+  }
+}
+bool io_service::process_transport(transport_handle_t transport)
+{
+  // the relay transport sends it's queued ops first, see io_service::relay
+  bool ok = !transport->relay_mode() ? (do_read(transport) && do_write(transport)) : (do_write(transport) && do_relay(transport));
+  if (ok)
+  {
+    int opm = transport->opmask_ | transport->ctx_->opmask_ | this->stop_flag_;
+    if (0 == opm)
+    { // no open/close/stop operations request
+      // visit again at next event loop: ssl handshaking, send queue not blocked by kernel buffer, kcp update
+      if (transport->state_ != io_base::state::OPENED || (!transport->pollout_registerred_ && !transport->send_queue_.empty()) ||
+          yasio__testbits(transport->ctx_->properties_, YCM_KCP))
+        mark_busy(transport);
+      return true;
+    }
+    if (transport->error_ == 0)
+      transport->error_ = yasio::errc::shutdown_by_localhost;
+  }
+  return false;
+}
+void io_service::collect_ready_transports()
+{
+  if (++this->visit_stamp_ == 0)
+    this->visit_stamp_ = 1;
+  ready_transports_.clear();
+  auto collect = [this](transport_handle_t transport) {
+    if (transport->visit_stamp_ != this->visit_stamp_)
+    {
+      transport->visit_stamp_ = this->visit_stamp_;
+      ready_transports_.push_back(transport);
+    }
+  };
+
+  // transports have io events
+  for (auto fd : io_watcher_.ready_fds())
+  {
+    auto transport = fd_transports_.get(fd);
+    if (transport && transport->is_valid() && transport->socket_->native_handle() == fd)
+      collect(transport);
+  }
+
+  // transports need visit by service self
+  for (auto transport : busy_transports_)
+  {
+    if (!transport) // closed, see io_service::handle_close
+      continue;
+    transport->busy_ = false;
+    collect(transport);
+  }
+  busy_transports_.clear();
+
+  // transports have write or close requests from other threads
+  std::lock_guard<std::mutex> lck(this->pending_transports_mtx_);
+  for (auto transport : pending_transports_)
+  {
+    if (!transport) // closed, see io_service::handle_close
+      continue;
+    transport->pending_ = false;
+    if (transport->is_valid())
+      collect(transport);
+  }
+  pending_transports_.clear();
+}
+bool io_service::has_channel_opmask() const
+{
+  for (auto channel : channels_)
+    if (channel->opmask_)
+      return true;
+  return false;
+}
+void io_service::start_loops()
+{
+  for (int i = 1; i < options_.io_loops_; ++i)
+  {
+    auto loop   = new io_service(static_cast<int>(channels_.size()));
+    loop->host_ = this;
+
+    auto& opts           = loop->options_;
+    opts.no_dispatch_    = true; // events will post to host
+    opts.deferred_event_ = options_.deferred_event_;
+    opts.on_defer_event_ = options_.on_defer_event_;
+    opts.forward_packet_ = options_.forward_packet_;
+    opts.ready_list_     = options_.ready_list_;
+    opts.udp_batch_      = options_.udp_batch_;
+    opts.tcp_keepalive_  = options_.tcp_keepalive_;
+    opts.print_          = options_.print_;
+#if defined(YASIO_SSL_BACKEND)
+    opts.cafile_  = options_.cafile_;
+    opts.crtfile_ = options_.crtfile_;
+    opts.keyfile_ = options_.keyfile_;
+#endif
+    loop->start(options_.on_event_);
+    loops_.push_back(loop);
+  }
+}
+void io_service::start_dispatchers()
+{
+  if (options_.dispatch_threads_ < 1)
+    return;
+  // the dispatchers hold copies, the callbacks may be reset at user thread
+  auto on_event       = options_.on_event_;
+  auto on_batch_event = options_.on_batch_event_;
+  dispatch_pool_.start(options_.dispatch_threads_, [this, on_event, on_batch_event](event_ptr* events, size_t count) {
+    int64_t weight = 0;
+    if (options_.event_high_mark_ > 0)
+      for (size_t i = 0; i < count; ++i)
+        weight += event_weight(events[i].get());
+    if (on_batch_event)
+      on_batch_event(events, count);
+    else if (on_event)
+    {
+      for (size_t i = 0; i < count; ++i)
+        on_event(std::move(events[i]));
+    }
+    if (options_.event_high_mark_ > 0)
+      untrack_events(weight);
+  });
+}
+void io_service::stop_loops()
+{
+  for (auto loop : loops_)
+    delete loop;
+  loops_.clear();
+}
+io_service* io_service::select_loop()
+{
+  if (loops_.empty())
+    return this;
+  if (options_.io_loops_balance_ == YLB_LEAST_LOADED)
+  {
+    io_service* target = this;
+    int min_load       = static_cast<int>(transports_.size());
+    for (auto loop : loops_)
+    {
+      int load = loop->workload_.load(std::memory_order_relaxed);
+      if (load < min_load)
+      {
+        min_load = load;
+        target   = loop;
+      }
+    }
+    return target;
+  }
+  auto index = next_loop_++ % (loops_.size() + 1);
+  return index == 0 ? this : loops_[index - 1];
+}
+void io_service::post_handoff(io_channel* source, xxsocket_ptr&& s, int opmask)
+{
+  if (s)
+    ++workload_;
+  handoff_mtx_.lock();
+  handoffs_.push_back(handoff_t{source, std::move(s), opmask});
+  handoff_mtx_.unlock();
+  this->wakeup();
+}
+void io_service::process_handoffs()
+{
+  std::vector<handoff_t> handoffs;
+  handoff_mtx_.lock();
+  handoffs.swap(handoffs_);
+  handoff_mtx_.unlock();
+
+  for (auto& handoff : handoffs)
+  {
+    auto source = handoff.source;
+    auto ctx    = channels_[source->index_];
+    if (ctx->connect_id_ != source->connect_id_)
+      mirror_channel(ctx, source);
+    if (handoff.socket)
+    {
+      handle_connect_succeed(ctx, std::move(handoff.socket));
+      continue;
+    }
+
+    // host server channel closed or reopened, close all transports of the mirrored channel
+    for (size_t i = 0; i < transports_.size();)
+    {
+      auto transport = transports_[i];
+      if (transport->ctx_ != ctx)
+      {
+        ++i;
         continue;
       }
       if (transport->error_ == 0)
         transport->error_ = yasio::errc::shutdown_by_localhost;
+      handle_close(transport);
+      remove_transport(transport);
     }
 
-    handle_close(transport);
-    iter = transports_.erase(iter);
+    // open or close the SO_REUSEPORT listener owned by this loop
+    int opmask = 0;
+    if (yasio__testbits(handoff.opmask, YOPM_OPEN) && yasio__testbits(ctx->properties_, YCF_REUSEPORT_LB) && yasio__testbits(ctx->properties_, YCM_TCP))
+      opmask = YOPM_OPEN;
+    else if (ctx->socket_->is_open())
+      opmask = YOPM_CLOSE;
+    if (opmask)
+    {
+      ctx->opmask_ = opmask;
+      if (yasio__find(this->channel_ops_, ctx) == this->channel_ops_.end())
+        this->channel_ops_.push_back(ctx);
+    }
+  }
+}
+void io_service::mirror_channel(io_channel* ctx, io_channel* source)
+{
+  ctx->properties_         = source->properties_ & 0x00ffffff;
+  ctx->socktype_           = source->socktype_;
+  ctx->remote_host_        = source->remote_host_;
+  ctx->remote_port_        = source->remote_port_;
+  ctx->uparams_            = source->uparams_;
+  ctx->decode_len_         = source->decode_len_;
+  ctx->backlog_            = source->backlog_;
+  ctx->max_accepts_        = source->max_accepts_;
+  ctx->zerocopy_threshold_ = source->zerocopy_threshold_;
+  ctx->ring_capacity_      = source->ring_capacity_;
+  ctx->send_high_mark_     = source->send_high_mark_;
+  ctx->send_low_mark_      = source->send_low_mark_;
+  ctx->connect_id_         = source->connect_id_;
+#if !defined(YASIO_MINIFY_EVENT)
+  ctx->ud_ = source->ud_;
+#endif
+}
+void io_service::notify_transport(transport_handle_t transport)
+{
+  if (options_.ready_list_ && !transport->pending_.exchange(true))
+  {
+    std::lock_guard<std::mutex> lck(this->pending_transports_mtx_);
+    transport->pending_slot_ = pending_transports_.size();
+    pending_transports_.push_back(transport);
+  }
+}
+void io_service::remove_transport(transport_handle_t transport)
+{
+  auto last                = transports_.back();
+  last->slot_              = transport->slot_;
+  transports_[last->slot_] = last;
+  transports_.pop_back();
+}
+void io_service::mark_busy(transport_handle_t transport)
+{
+  if (options_.ready_list_ && !transport->busy_)
+  {
+    transport->busy_      = true;
+    transport->busy_slot_ = busy_transports_.size();
+    busy_transports_.push_back(transport);
   }
 }
 void io_service::process_channels()
@@ -1041,7 +2153,6 @@ void io_service::process_channels()
   if (!this->channel_ops_.empty())
   {
     // perform active channels
-    std::lock_guard<std::recursive_mutex> lck(this->channel_ops_mtx_);
     for (auto iter = this->channel_ops_.begin(); iter != this->channel_ops_.end();)
     {
       auto ctx    = *iter;
@@ -1068,6 +2179,11 @@ void io_service::process_channels()
       else if (yasio__testbits(ctx->properties_, YCM_SERVER))
       {
         auto opmask = ctx->opmask_;
+        if (!loops_.empty() && yasio__testbits(opmask, YOPM_OPEN | YOPM_CLOSE))
+        {
+          for (auto loop : loops_)
+            loop->post_handoff(ctx, nullptr, opmask);
+        }
         if (yasio__testbits(opmask, YOPM_OPEN))
           do_accept(ctx);
         else if (yasio__testbits(opmask, YOPM_CLOSE))
@@ -1109,9 +2225,27 @@ void io_service::close(transport_handle_t transport)
   if (!yasio__testbits(transport->opmask_, YOPM_CLOSE))
   {
     yasio__setbits(transport->opmask_, YOPM_CLOSE);
-    this->wakeup();
+    auto& service = transport->get_service(); // may owned by worker loop
+    service.notify_transport(transport);
+    service.wakeup();
   }
 }
+void io_service::pause_read(transport_handle_t transport)
+{
+  io_command cmd;
+  cmd.kind         = command_kind::PAUSE_READ;
+  cmd.transport    = transport;
+  cmd.transport_id = transport->id_;
+  transport->get_service().post_command(std::move(cmd)); // may owned by worker loop
+}
+void io_service::resume_read(transport_handle_t transport)
+{
+  io_command cmd;
+  cmd.kind         = command_kind::RESUME_READ;
+  cmd.transport    = transport;
+  cmd.transport_id = transport->id_;
+  transport->get_service().post_command(std::move(cmd));
+}
 bool io_service::is_open(transport_handle_t transport) const { return transport->is_open(); }
 bool io_service::is_open(int index) const
 {
@@ -1148,6 +2282,17 @@ void io_service::handle_close(transport_handle_t thandle)
     if (--nsched_ <= 0) // if no sched transport, reset sched_freq to max wait 5mins
       sched_freq_ = yasio__max_wait_usec;
   }
+  if (thandle->relay_mode())
+  { // the relay pair closed together
+    YASIO_KLOGD("[index: %d] the relay of connection #%u is closed, bytes relayed: %llu", ctx->index_, thandle->id_,
+                static_cast<unsigned long long>(thandle->relayed_bytes()));
+    auto peer = thandle->relay_peer_;
+    if (peer)
+    {
+      peer->relay_peer_ = nullptr;
+      close(peer);
+    }
+  }
   if (thandle->state_ == io_base::state::OPENED)
   { // @Because we can't retrive peer endpoint when connect reset by peer, so use id to trace.
     YASIO_KLOGD("[index: %d] the connection #%u is lost, ec=%d, where=%d, detail:%s", ctx->index_, thandle->id_, error, (int)thandle->error_stage_,
@@ -1157,11 +2302,36 @@ void io_service::handle_close(transport_handle_t thandle)
 #if defined(YASIO_SSL_BACKEND)
   if (yasio__testbits(ctx->properties_, YCM_SSL))
     static_cast<io_transport_ssl*>(thandle)->do_ssl_shutdown();
+#endif
+#if YASIO__HAS_ZEROCOPY
+  thandle->abort_zerocopy(error != 0 ? error : yasio::errc::shutdown_by_localhost);
 #endif
   if (yasio__testbits(ctx->properties_, YCM_TCP) && error == yasio::errc::shutdown_by_localhost)
     thandle->socket_->shutdown();
+  if (options_.ready_list_)
+  {
+    auto fd = thandle->socket_->native_handle();
+    if (fd_transports_.get(fd) == thandle)
+      fd_transports_.erase(fd);
+    // leave a nullptr in the slot, skipped at next collect
+    if (thandle->busy_)
+      busy_transports_[thandle->busy_slot_] = nullptr;
+    if (thandle->pending_)
+    { // the pending_ flag set before pushed by other thread, so check the slot owned by it
+      std::lock_guard<std::mutex> lck(this->pending_transports_mtx_);
+      auto slot = thandle->pending_slot_;
+      if (slot < pending_transports_.size() && pending_transports_[slot] == thandle)
+        pending_transports_[slot] = nullptr;
+    }
+  }
+  if (yasio__testbits(thandle->read_paused_, io_transport::READ_PAUSED_BY_BACKPRESSURE))
+    paused_transports_[thandle->paused_slot_] = nullptr;
+  if (!thandle->groups_.empty())
+    leave_groups(thandle);
   cleanup_io(thandle);
   deallocate_transport(thandle);
+  if (this->host_)
+    --workload_;
   if (client)
   {
     yasio__clearbits(ctx->opmask_, YOPM_CLOSE);
@@ -1188,6 +2358,49 @@ int io_service::forward(transport_handle_t transport, const void* buf, size_t le
     return -1;
   }
 }
+int io_service::broadcast(const transport_handle_t* transports, size_t count, shared_buffer_ptr buffer, completion_cb_t handler)
+{
+  if (!buffer || buffer->empty())
+    return 0;
+  int queued = 0;
+  std::vector<io_service*> owners; // the worker loops which own the transports, usually few
+  for (size_t i = 0; i < count; ++i)
+  {
+    auto transport = transports[i];
+    if (!transport || !transport->is_open())
+      continue;
+    transport->enqueue(transport->make_send_op(io_send_buffer{buffer}, completion_cb_t{handler}), false);
+    auto owner = &transport->get_service();
+    if (yasio__find(owners, owner) == owners.end())
+      owners.push_back(owner);
+    ++queued;
+  }
+  for (auto owner : owners)
+    owner->wakeup();
+  return queued;
+}
+void io_service::join_group(transport_handle_t transport, cxx17::string_view group) { post_group_command(command_kind::JOIN_GROUP, transport, group); }
+void io_service::leave_group(transport_handle_t transport, cxx17::string_view group) { post_group_command(command_kind::LEAVE_GROUP, transport, group); }
+void io_service::publish(cxx17::string_view group, shared_buffer_ptr buffer, completion_cb_t handler)
+{
+  if (!buffer || buffer->empty())
+    return;
+  auto op = std::make_shared<io_group_op>();
+  cxx17::assign(op->group, group);
+  op->buffer  = std::move(buffer);
+  op->handler = std::move(handler);
+  for (auto loop : loops_)
+  { // each worker loop fans out to the members it owns
+    io_command cmd;
+    cmd.kind     = command_kind::PUBLISH;
+    cmd.group_op = op;
+    loop->post_command(std::move(cmd));
+  }
+  io_command cmd;
+  cmd.kind     = command_kind::PUBLISH;
+  cmd.group_op = std::move(op);
+  post_command(std::move(cmd));
+}
 int io_service::write_to(transport_handle_t transport, sbyte_buffer buffer, const ip::endpoint& to, completion_cb_t handler)
 {
   if (transport && transport->is_open())
@@ -1208,6 +2421,66 @@ int io_service::forward_to(transport_handle_t transport, const void* buf, size_t
     return -1;
   }
 }
+int io_service::relay(transport_handle_t transport, transport_handle_t peer)
+{
+  auto relayable = [](transport_handle_t t) { return t && (t->ctx_->properties_ & (YCM_TCP | YCM_SSL)) == YCM_TCP; };
+  if (transport != peer && relayable(transport) && relayable(peer) && &transport->get_service() == &peer->get_service())
+  { // the relay states owned by io thread, pair them there
+    io_command cmd;
+    cmd.kind         = command_kind::RELAY;
+    cmd.transport    = transport;
+    cmd.transport_id = transport->id_;
+    cmd.peer         = peer;
+    cmd.peer_id      = peer->id_;
+    transport->get_service().post_command(std::move(cmd)); // may owned by worker loop
+    return 0;
+  }
+  YASIO_KLOGE("relay failed, the connections not stream transports of same io loop!");
+  return -1;
+}
+int io_service::write_file(transport_handle_t transport, int fd, int64_t offset, int64_t length, completion_cb_t handler)
+{
+  return enqueue_file(transport, fd, false, offset, length, std::move(handler));
+}
+int io_service::write_file(transport_handle_t transport, const char* path, int64_t offset, int64_t length, completion_cb_t handler)
+{
+  int fd = yasio__file_open(path);
+  if (fd != -1)
+    return enqueue_file(transport, fd, true, offset, length, std::move(handler));
+  YASIO_KLOGE("write_file failed, can't open file: %s, ec=%d", path, errno);
+  return -1;
+}
+int io_service::enqueue_file(transport_handle_t transport, int fd, bool owns_fd, int64_t offset, int64_t length, completion_cb_t&& handler)
+{
+  if (!transport || !transport->is_open() || !yasio__testbits(transport->ctx_->properties_, YCM_TCP))
+  {
+    if (owns_fd)
+      yasio__file_close(fd);
+    YASIO_KLOGE("write_file failed, the connection not ok or not stream transport!");
+    return -1;
+  }
+
+  // the non-regular file, i.e. pipe, may block the io thread when read
+  auto size = yasio__file_size(fd);
+  if (size < 0)
+  {
+    if (owns_fd)
+      yasio__file_close(fd);
+    YASIO_KLOGE("write_file failed, the fd=%d is not a regular file!", fd);
+    return -1;
+  }
+
+  // clamp the range to file size
+  int mode           = io_sendfile_op::mode_read;
+  offset             = yasio::clamp(offset, static_cast<int64_t>(0), size);
+  auto bytes_to_send = static_cast<size_t>((length > 0 && length < size - offset) ? length : size - offset);
+#if YASIO__HAS_SENDFILE
+  if (!yasio__testbits(transport->ctx_->properties_, YCM_SSL))
+    mode = io_sendfile_op::mode_sendfile;
+#endif
+  transport->enqueue(cxx14::make_unique<io_sendfile_op>(fd, owns_fd, offset, bytes_to_send, mode, std::move(handler)));
+  return 0;
+}
 void io_service::do_connect(io_channel* ctx)
 {
   assert(!ctx->remote_eps_.empty());
@@ -1497,7 +2770,7 @@ void io_service::do_accept(io_channel* ctx)
       break;
     }
 
-    if (yasio__testbits(ctx->properties_, YCF_REUSEADDR))
+    if (yasio__testbits(ctx->properties_, YCF_REUSEADDR | YCF_REUSEPORT_LB))
       ctx->socket_->reuse_address(true);
     if (yasio__testbits(ctx->properties_, YCF_EXCLUSIVEADDRUSE))
       ctx->socket_->exclusive_address(false);
@@ -1507,17 +2780,27 @@ void io_service::do_accept(io_channel* ctx)
       break;
     }
 
-    if (yasio__testbits(ctx->properties_, YCM_TCP) && ctx->socket_->listen(YASIO_SOMAXCONN) != 0)
+    if (yasio__testbits(ctx->properties_, YCM_TCP) && ctx->socket_->listen(ctx->backlog_) != 0)
     {
       where = io_base::error_stage::LISTEN_SOCKET;
       break;
     }
+#if defined(SO_ATTACH_REUSEPORT_CBPF)
+    // the host listener is the first one of SO_REUSEPORT group, the program applies to whole group
+    if (!this->host_ && yasio__testbits(ctx->properties_, YCF_REUSEPORT_CBPF) && yasio__testbits(ctx->properties_, YCF_REUSEPORT_LB) &&
+        yasio__attach_reuseport_cbpf(ctx->socket_.get(), static_cast<int>(loops_.size() + 1)) != 0)
+      YASIO_KLOGW("[index: %d] attach reuseport cbpf failed, ec=%d", ctx->index_, xxsocket::get_last_errno());
+#endif
 
     ctx->state_ = io_base::state::OPENED;
     if (yasio__testbits(ctx->properties_, YCM_UDP))
     {
       if (yasio__testbits(ctx->properties_, YCPF_MCAST))
         ctx->join_multicast_group();
+#if YASIO__HAS_MMSG
+      if (yasio__testbits(ctx->properties_, YCF_UDP_GRO))
+        ctx->socket_->set_optval(SOL_UDP, UDP_GRO, 1);
+#endif
       ctx->buffer_.resize(yasio__max_rcvbuf);
     }
     io_watcher_.mod_event(ctx->socket_->native_handle(), socket_event::read, 0);
@@ -1533,7 +2816,8 @@ void io_service::do_accept(io_channel* ctx)
     ctx->state_ = io_base::state::CLOSED;
   }
 #if defined(YASIO_ENABLE_PASSIVE_EVENT)
-  this->fire_event(ctx->index_, YEK_ON_OPEN, error, ctx, 1);
+  if (!this->host_) // the listeners of worker loops are transparent to user
+    this->fire_event(ctx->index_, YEK_ON_OPEN, error, ctx, 1);
 #endif
 }
 void io_service::do_accept_completion(io_channel* ctx)
@@ -1545,48 +2829,80 @@ void io_service::do_accept_completion(io_channel* ctx)
     {
       if (yasio__testbits(ctx->properties_, YCM_TCP))
       {
+        // drain the accept queue, avoid accept one connection per poll_io when lots of clients connecting
         socket_native_type sockfd{invalid_socket};
-        error = ctx->socket_->paccept(sockfd);
-        if (error == 0)
-          handle_connect_succeed(ctx, std::make_shared<xxsocket>(sockfd));
-        else // The non-blocking tcp accept failed can be ignored.
-          YASIO_KLOGV("[index: %d] socket.fd=%d, accept failed, ec=%u", ctx->index_, (int)ctx->socket_->native_handle(), error);
+        for (int n = 0; ctx->max_accepts_ <= 0 || n < ctx->max_accepts_; ++n)
+        {
+          error = ctx->socket_->paccept(sockfd);
+          if (error != 0)
+          { // the accept queue drained, or the non-blocking tcp accept failed can be ignored.
+            if (!xxsocket::not_recv_error(error))
+              YASIO_KLOGE("[index: %d] socket.fd=%d, accept failed, ec=%d, detail:%s", ctx->index_, (int)ctx->socket_->native_handle(), error,
+                          this->strerror(error));
+            break;
+          }
+          handle_accept_succeed(ctx, std::make_shared<xxsocket>(sockfd));
+        }
       }
       else // YCM_UDP
       {
-        ip::endpoint peer;
-        int n = ctx->socket_->recvfrom(&ctx->buffer_.front(), static_cast<int>(ctx->buffer_.size()), peer);
-        if (n > 0)
+        int n = 0;
+#if YASIO__HAS_MMSG
+        if (options_.udp_batch_ > 1 || yasio__testbits(ctx->properties_, YCF_UDP_GRO))
         {
-          YASIO_KLOGV("[index: %d] recvfrom peer: %s succeed.", ctx->index_, peer.to_string().c_str());
-          auto transport = static_cast<io_transport_udp*>(do_dgram_accept(ctx, peer, error));
-          if (transport)
-          {
-            if (transport->handle_input(ctx->buffer_.data(), n, error, this->wait_duration_) < 0)
-            {
-              transport->error_ = error;
-              close(transport);
-            }
-          }
-          else
-            YASIO_KLOGE("[index: %d] do_dgram_accept failed, ec=%d, detail:%s", ctx->index_, error, this->strerror(error));
+          n = recv_mmsg(ctx->socket_.get(), error);
+          yasio__visit_mmsg(mmsg_hdrs_.data(), n, [this, ctx](int i, char* data, int len) {
+            handle_dgram_accept(ctx, mmsg_peers_[i], data, len);
+            return true;
+          });
         }
-        else if (n < 0)
+        else
+#endif
         {
-          error = xxsocket::get_last_errno();
-          if (!xxsocket::not_recv_error(error))
-            YASIO_KLOGE("[index: %d] recvfrom failed, ec=%d, detail:%s", ctx->index_, error, this->strerror(error));
+          ip::endpoint peer;
+          n = ctx->socket_->recvfrom(&ctx->buffer_.front(), static_cast<int>(ctx->buffer_.size()), peer);
+          if (n > 0)
+            handle_dgram_accept(ctx, peer, ctx->buffer_.data(), n);
+          else if (n < 0)
+            error = xxsocket::get_last_errno();
         }
+        if (n < 0 && !xxsocket::not_recv_error(error))
+          YASIO_KLOGE("[index: %d] recvfrom failed, ec=%d, detail:%s", ctx->index_, error, this->strerror(error));
       }
     }
   }
 }
+void io_service::handle_accept_succeed(io_channel* ctx, xxsocket_ptr&& s)
+{
+  // every loop owns a SO_REUSEPORT listener, the kernel already balanced it
+  auto loop = !yasio__testbits(ctx->properties_, YCF_REUSEPORT_LB) ? select_loop() : this;
+  if (loop == this)
+    handle_connect_succeed(ctx, std::move(s));
+  else
+    loop->post_handoff(ctx, std::move(s));
+}
 int io_service::local_address_family() const
 {
   if (!yasio__testbits(ipsv_, ipsv_ipv4))
     ipsv_ = static_cast<u_short>(xxsocket::getipsv());
   return ((ipsv_ & ipsv_ipv4) || !ipsv_) ? AF_INET : AF_INET6;
 }
+void io_service::handle_dgram_accept(io_channel* ctx, const ip::endpoint& peer, char* data, int n)
+{
+  YASIO_KLOGV("[index: %d] recvfrom peer: %s succeed.", ctx->index_, peer.to_string().c_str());
+  int error      = 0;
+  auto transport = static_cast<io_transport_udp*>(do_dgram_accept(ctx, peer, error));
+  if (transport)
+  {
+    if (transport->handle_input(data, n, error, this->wait_duration_) < 0)
+    {
+      transport->error_ = error;
+      close(transport);
+    }
+  }
+  else
+    YASIO_KLOGE("[index: %d] do_dgram_accept failed, ec=%d, detail:%s", ctx->index_, error, this->strerror(error));
+}
 transport_handle_t io_service::do_dgram_accept(io_channel* ctx, const ip::endpoint& peer, int& error)
 {
   /*
@@ -1658,7 +2974,19 @@ void io_service::handle_connect_succeed(transport_handle_t transport)
     // apply tcp keepalive options
     if (options_.tcp_keepalive_.onoff)
       connection->set_keepalive(options_.tcp_keepalive_.onoff, options_.tcp_keepalive_.idle, options_.tcp_keepalive_.interval, options_.tcp_keepalive_.probs);
+#if YASIO__HAS_ZEROCOPY
+    if (ctx->zerocopy_threshold_ > 0 && !yasio__testbits(ctx->properties_, YCM_SSL | YCM_UDS) && connection->set_optval(SOL_SOCKET, SO_ZEROCOPY, 1) == 0)
+      transport->zc_threshold_ = ctx->zerocopy_threshold_;
+#endif
+    if (ctx->ring_capacity_ > 0 && !options_.forward_packet_)
+    {
+      transport->rbuf_ = cxx14::make_unique<mirrored_buffer>();
+      if (!transport->rbuf_->init(static_cast<size_t>(ctx->ring_capacity_)))
+        transport->rbuf_.reset(); // fallback to the legacy unpack
+    }
   }
+  transport->send_high_mark_ = ctx->send_high_mark_;
+  transport->send_low_mark_  = ctx->send_low_mark_;
 #if !defined(_WIN32) // windows: UDP will ignore sndbuf, other: ensure sndbuf >= max_ip_mtu(65535)
   if (yasio__testbits(ctx->properties_, YCM_UDP))
   {
@@ -1673,7 +3001,13 @@ void io_service::active_transport(transport_handle_t t)
 {
   auto ctx = t->ctx_;
   auto& s  = t->socket_;
+  t->slot_ = transports_.size();
   this->transports_.push_back(t);
+  if (options_.ready_list_)
+  {
+    fd_transports_.at(s->native_handle()) = t;
+    mark_busy(t);
+  }
   if (yasio__testbits(ctx->properties_, YCM_KCP))
   {
     ++this->nsched_;
@@ -1749,83 +3083,293 @@ void io_service::handle_connect_failed(io_channel* ctx, int error)
 }
 bool io_service::do_read(transport_handle_t transport)
 {
-  bool ret = false;
-  do
+  if (!transport->socket_->is_open())
+    return false;
+#if YASIO__HAS_ZEROCOPY
+  // the zero-copy completions queued at socket error queue always report the error event, which can't be masked by
+  // removing read interest, so reap them even the read paused, otherwise the loop spins
+  if (transport->zerocopy_pending() && io_watcher_.is_ready(transport->socket_->native_handle(), socket_event::read | socket_event::error))
+    transport->reap_zerocopy();
+#endif
+  if (transport->read_paused_)
+    return true;
+#if YASIO__HAS_MMSG
+  if ((options_.udp_batch_ > 1 || yasio__testbits(transport->ctx_->properties_, YCF_UDP_GRO)) && yasio__testbits(transport->ctx_->properties_, YCM_UDP) &&
+      !yasio__testbits(transport->ctx_->properties_, YCM_KCP) && static_cast<io_transport_udp*>(transport)->connected_)
+    return do_read_mmsg(transport);
+#endif
+  int error  = 0;
+  int revent = io_watcher_.is_ready(transport->socket_->native_handle(), socket_event::read | socket_event::error);
+  int n = transport->do_read(revent, error, this->wait_duration_);
+  if (n < 0)
+  { // n < 0, regard as connection should close
+    transport->set_last_errno(error, yasio::io_base::error_stage::READ);
+    return false;
+  }
+  bool ok = !transport->rbuf_ ? handle_read(transport, n) : unpack_ring(transport, n);
+  transport->return_buffer();
+  // stop reading the transports still receiving when the event queue reach high watermark
+  if (yasio__unlikely(ok && n > 0 && event_queue_full()) && read_pausable(transport))
+    throttle_read(transport);
+  return ok;
+}
+bool io_service::handle_read(transport_handle_t transport, int n)
+{
+  if (!options_.forward_packet_)
   {
-    if (!transport->socket_->is_open())
-      break;
-    int error  = 0;
-    int revent = io_watcher_.is_ready(transport->socket_->native_handle(), socket_event::read | socket_event::error);
-    int n      = transport->do_read(revent, error, this->wait_duration_);
-    if (n >= 0)
+    YASIO_KLOGV("[index: %d] do_read status ok, bytes transferred: %d, buffer used: %d", transport->cindex(), n, n + transport->offset_);
+    const int bytes_to_strip = transport->ctx_->uparams_.initial_bytes_to_strip;
+    const int bytes_available = transport->offset_ + n;
+    int bytes_consumed        = 0;
+    // unpack all complete pdus received in one pass, only the incomplete header remains in buffer
+    while (bytes_consumed < bytes_available)
     {
-      if (!options_.forward_packet_)
-      {
-        YASIO_KLOGV("[index: %d] do_read status ok, bytes transferred: %d, buffer used: %d", transport->cindex(), n, n + transport->offset_);
-        const int bytes_to_strip = transport->ctx_->uparams_.initial_bytes_to_strip;
-        if (transport->expected_size_ == -1)
-        { // decode length
-          int length = transport->ctx_->decode_len_(transport->buffer_, transport->offset_ + n);
-          if (length > 0)
-          {
-            if (length < bytes_to_strip)
-            {
-              transport->set_last_errno(yasio::errc::invalid_packet, yasio::io_base::error_stage::READ);
-              break;
-            }
-            transport->expected_size_ = length;
-            transport->expected_packet_.reserve((std::min)(length - bytes_to_strip,
-                                                           YASIO_MAX_PDU_BUFFER_SIZE)); // #perfomance, avoid memory reallocte.
-            unpack(transport, transport->expected_size_, n, bytes_to_strip);
-          }
-          else if (length == 0) // header insufficient, wait readfd ready at next event frame.
-            transport->offset_ += n;
-          else
+      if (transport->expected_size_ == -1)
+      { // decode length
+        int length = transport->ctx_->decode_len_(transport->buffer_ + bytes_consumed, bytes_available - bytes_consumed);
+        if (length > 0)
+        {
+          if (length < bytes_to_strip)
           {
             transport->set_last_errno(yasio::errc::invalid_packet, yasio::io_base::error_stage::READ);
-            break;
+            return false;
           }
+          transport->expected_size_ = length;
+          transport->expected_packet_.reserve((std::min)(length - bytes_to_strip,
+                                                         YASIO_MAX_PDU_BUFFER_SIZE)); // #perfomance, avoid memory reallocte.
+          bytes_consumed += unpack(transport, transport->buffer_ + bytes_consumed, length, bytes_available - bytes_consumed, bytes_to_strip);
+        }
+        else if (length == 0) // header insufficient, wait readfd ready at next event frame.
+          break;
+        else
+        {
+          transport->set_last_errno(yasio::errc::invalid_packet, yasio::io_base::error_stage::READ);
+          return false;
         }
-        else // process incompleted pdu
-          unpack(transport, transport->expected_size_ - static_cast<int>(transport->expected_packet_.size() + bytes_to_strip), n, 0);
       }
-      else if (n > 0)
-      { // forward packet, don't perform unpack, it's useful for implement streaming based protocol, like http, websocket and ...
-        this->forward_packet(transport->cindex(), io_packet_view{transport->buffer_, n}, transport);
+      else // process incompleted pdu
+        bytes_consumed += unpack(transport, transport->buffer_ + bytes_consumed,
+                                 transport->expected_size_ - static_cast<int>(transport->expected_packet_.size() + bytes_to_strip), bytes_available - bytes_consumed, 0);
+    }
+    // move the incomplete header to head of buffer and hold 'offset'.
+    transport->offset_ = bytes_available - bytes_consumed;
+    if (transport->offset_ > 0 && bytes_consumed > 0)
+      ::memmove(transport->buffer_, transport->buffer_ + bytes_consumed, transport->offset_);
+  }
+  else if (n > 0)
+  { // forward packet, don't perform unpack, it's useful for implement streaming based protocol, like http, websocket and ...
+    this->forward_packet(transport->cindex(), io_packet_view{transport->buffer_, n}, transport);
+  }
+  return true;
+}
+bool io_service::unpack_ring(transport_handle_t transport, int n)
+{
+  auto rbuf = transport->rbuf_.get();
+  rbuf->commit(n);
+  YASIO_KLOGV("[index: %d] do_read status ok, bytes transferred: %d, ring used: %d", transport->cindex(), n, static_cast<int>(rbuf->size()));
+  const int bytes_to_strip = transport->ctx_->uparams_.initial_bytes_to_strip;
+  // dispatch all complete frames as views of the ring, the partial frame stay in place
+  while (rbuf->size() > 0)
+  {
+    int available = static_cast<int>(rbuf->size());
+    int length    = transport->ctx_->decode_len_(rbuf->data(), available);
+    if (length > 0)
+    {
+      if (length < bytes_to_strip || static_cast<size_t>(length) > rbuf->capacity())
+      {
+        transport->set_last_errno(yasio::errc::invalid_packet, yasio::io_base::error_stage::READ);
+        return false;
       }
+      if (length > available)
+        break; // frame incomplete, wait readfd ready at next event frame.
+      this->forward_packet(transport->cindex(), io_packet_view{rbuf->data() + bytes_to_strip, length - bytes_to_strip}, transport);
+      rbuf->consume(length);
     }
-    else
-    { // n < 0, regard as connection should close
-      transport->set_last_errno(error, yasio::io_base::error_stage::READ);
+    else if (length == 0) // header insufficient
       break;
+    else
+    {
+      transport->set_last_errno(yasio::errc::invalid_packet, yasio::io_base::error_stage::READ);
+      return false;
     }
-    ret = true;
-  } while (false);
-  return ret;
+  }
+  return true;
+}
+bool io_service::do_relay(transport_handle_t transport)
+{
+  auto peer = transport->relay_peer_;
+  if (!peer)
+  { // the peer closed
+    transport->set_last_errno(yasio::errc::shutdown_by_localhost, yasio::io_base::error_stage::READ);
+    return false;
+  }
+  if ((!transport->relay_ || !peer->relay_) && !start_relay(transport))
+  {
+    transport->set_last_errno(xxsocket::get_last_errno(), yasio::io_base::error_stage::READ);
+    return false;
+  }
+  int error = 0;
+  if (relay_transfer(transport, peer, error) && relay_transfer(peer, transport, error))
+  {
+    if (!transport->relay_->shutdown_ || !peer->relay_->shutdown_)
+      return true;
+    error = yasio::errc::eof; // both directions reach EOF
+  }
+  transport->set_last_errno(error, yasio::io_base::error_stage::READ);
+  return false;
+}
+bool io_service::start_relay(transport_handle_t transport)
+{
+#if YASIO__HAS_SENDFILE
+  yasio__block_sigpipe();
+#endif
+  for (auto t : {transport, transport->relay_peer_})
+  {
+    if (t->relay_)
+      continue;
+    t->relay_ = cxx14::make_unique<io_relay_pipe>();
+    if (!t->relay_->is_valid())
+      return false;
+    // the bytes received but not dispatched as packet, forward them to peer first
+    sbyte_buffer pending = std::move(t->expected_packet_);
+    if (t->offset_ > 0)
+      pending.append(t->buffer_, t->buffer_ + t->offset_);
+    if (t->rbuf_)
+    {
+      pending.append(t->rbuf_->data(), t->rbuf_->data() + t->rbuf_->size());
+      t->rbuf_.reset();
+    }
+    t->expected_size_ = -1;
+    t->offset_        = 0;
+    t->return_buffer();
+    if (!pending.empty())
+      t->relay_peer_->write(io_send_buffer{std::move(pending)}, nullptr);
+  }
+  return true;
 }
-void io_service::unpack(transport_handle_t transport, int bytes_want /*want consume bytes from recv buffer per time*/, int bytes_transferred,
-                        int bytes_to_strip)
+bool io_service::relay_transfer(transport_handle_t source, transport_handle_t target, int& error)
 {
-  auto& offset         = transport->offset_;
-  auto bytes_available = bytes_transferred + offset;
-  auto& pkt            = transport->expected_packet_;
-  pkt.insert(pkt.end(), transport->buffer_ + bytes_to_strip, transport->buffer_ + (std::min)(bytes_want, bytes_available));
+  auto relay          = source->relay_.get();
+  const bool readable = io_watcher_.is_ready(source->socket_->native_handle(), socket_event::read | socket_event::error) != 0;
+  for (int rounds = 0;; ++rounds)
+  {
+    if (relay->pending_ > 0 && target->send_queue_.empty())
+    { // the queued ops of target always sent before the relay bytes
+      int n = relay->flush(target->socket_.get());
+      if (n > 0)
+      {
+        relay->pending_ -= n;
+        relay->bytes_ += n;
+      }
+      else if (n < 0 && !xxsocket::not_send_error(error = xxsocket::get_last_errno()))
+        return false;
+    }
+    if (relay->pending_ > 0 || relay->eof_ || !readable || rounds == yasio__max_relay_rounds)
+      break;
+    int n = relay->fill(source->socket_.get());
+    if (n > 0)
+    {
+      relay->pending_ += n;
+      source->ctx_->bytes_transferred_ += n;
+    }
+    else if (n == 0)
+      relay->eof_ = true;
+    else if (!xxsocket::not_recv_error(error = xxsocket::get_last_errno()))
+      return false;
+    else
+      break;
+  }
+  error = 0;
+
+  // backpressure: pause the read of source until the pipe drained to target, and stop it once the source reach EOF,
+  // otherwise the readable EOF wakeup the loop forever
+  const bool blocked = relay->pending_ > 0;
+  set_read_paused(source, io_transport::READ_PAUSED_BY_RELAY, blocked || relay->eof_);
+  if (blocked && !target->pollout_registerred_)
+  { // wait target writable, the pollout will be unregistered by target->do_write
+    io_watcher_.mod_event(target->socket_->native_handle(), socket_event::write, 0);
+    target->pollout_registerred_ = true;
+  }
 
-  // set 'offset' to bytes of remain buffer
-  offset = bytes_available - bytes_want;
-  if (offset >= 0)
+  // half-close: propagate the EOF of source to target after all bytes sent
+  if (relay->eof_ && !blocked && !relay->shutdown_ && target->send_queue_.empty())
+  {
+    target->socket_->shutdown(SD_SEND);
+    relay->shutdown_ = true;
+  }
+  return true;
+}
+#if YASIO__HAS_MMSG
+int io_service::recv_mmsg(xxsocket* s, int& error)
+{
+  const int vlen = options_.udp_batch_;
+  if (mmsg_hdrs_.size() != static_cast<size_t>(vlen))
+  {
+    mmsg_hdrs_.resize(vlen);
+    mmsg_iovs_.resize(vlen);
+    mmsg_peers_.resize(vlen);
+    mmsg_buffer_.resize(static_cast<size_t>(vlen) * yasio__max_rcvbuf);
+    mmsg_controls_.resize(static_cast<size_t>(vlen) * sizeof(yasio__udp_cmsg));
+    for (int i = 0; i < vlen; ++i)
+      xxsocket::set_iovec(mmsg_iovs_[i], mmsg_buffer_.data() + static_cast<size_t>(i) * yasio__max_rcvbuf, yasio__max_rcvbuf);
+  }
+  for (int i = 0; i < vlen; ++i)
+  { // the msg_namelen is value-result argument, so reset per call
+    auto& msg = mmsg_hdrs_[i];
+    ::memset(&msg, 0, sizeof(msg));
+    msg.msg_hdr.msg_name    = &mmsg_peers_[i];
+    msg.msg_hdr.msg_namelen = sizeof(ip::endpoint);
+    msg.msg_hdr.msg_iov     = &mmsg_iovs_[i];
+    msg.msg_hdr.msg_iovlen  = 1;
+    msg.msg_hdr.msg_control    = &mmsg_controls_[i * sizeof(yasio__udp_cmsg)];
+    msg.msg_hdr.msg_controllen = sizeof(yasio__udp_cmsg);
+  }
+  int n = s->recvmmsg(mmsg_hdrs_.data(), vlen);
+  if (n < 0)
+    error = xxsocket::get_last_errno();
+  for (int i = 0; i < n; ++i)
+    mmsg_peers_[i].len(mmsg_hdrs_[i].msg_hdr.msg_namelen);
+  return n;
+}
+bool io_service::do_read_mmsg(transport_handle_t transport)
+{
+  if (!io_watcher_.is_ready(transport->socket_->native_handle(), socket_event::read | socket_event::error))
+    return true;
+  int error = 0;
+  int n     = recv_mmsg(transport->socket_.get(), error);
+  if (n < 0)
+  {
+    if (xxsocket::not_recv_error(error))
+      return true;
+    transport->set_last_errno(error, yasio::io_base::error_stage::READ);
+    return false;
+  }
+  bool ok = yasio__visit_mmsg(mmsg_hdrs_.data(), n, [this, transport](int, char* data, int len) {
+    // the datagram handled as it read to transport recv buffer directly
+    auto buf              = transport->borrow_buffer();
+    int bytes_transferred = (std::min)(len, yasio__max_rcvbuf - transport->offset_);
+    ::memcpy(buf + transport->offset_, data, bytes_transferred);
+    transport->ctx_->bytes_transferred_ += bytes_transferred;
+    return handle_read(transport, bytes_transferred);
+  });
+  transport->return_buffer();
+  return ok;
+}
+#endif
+int io_service::unpack(transport_handle_t transport, const char* data, int bytes_want /*want consume bytes from recv buffer per time*/, int bytes_available,
+                       int bytes_to_strip)
+{
+  int bytes_consumed = (std::min)(bytes_want, bytes_available);
+  auto& pkt          = transport->expected_packet_;
+  pkt.insert(pkt.end(), data + bytes_to_strip, data + bytes_consumed);
+  if (bytes_consumed == bytes_want)
   { /* pdu received properly */
-    if (offset > 0)
-    { /* move remain data to head of buffer and hold 'offset'. */
-      ::memmove(transport->buffer_, transport->buffer_ + bytes_want, offset);
-      this->wait_duration_ = 0;
-    }
     // move properly pdu to ready queue, the other thread who care about will retrieve it.
     YASIO_KLOGV("[index: %d] received a properly packet from peer, packet size:%d", transport->cindex(), transport->expected_size_);
     this->fire_event(transport->cindex(), transport->fetch_packet(), transport);
   }
-  else /* all buffer consumed, set 'offset' to ZERO, pdu incomplete, continue recv remain data. */
-    offset = 0;
+  /* else: all buffer consumed, pdu incomplete, continue recv remain data. */
+  return bytes_consumed;
 }
 highp_timer_ptr io_service::schedule(const std::chrono::microseconds& duration, timer_cb_t cb)
 {
@@ -1844,32 +3388,223 @@ void io_service::schedule_timer(highp_timer* timer_ctl, timer_cb_t&& timer_cb)
   if (timer_ctl == nullptr)
     return;
 
-  std::lock_guard<std::recursive_mutex> lck(this->timer_queue_mtx_);
-  auto timer_it = this->find_timer(timer_ctl);
-  if (timer_it == timer_queue_.end())
-    this->timer_queue_.emplace_back(timer_ctl, std::move(timer_cb));
-  else // always replace timer_cb
-    timer_it->second = std::move(timer_cb);
-
-  this->sort_timers();
-  // If the timer is earliest, wakup
-  if (timer_ctl == this->timer_queue_.back().first)
-    this->wakeup();
+  auto& state = timer_ctl->state_;
+  io_command cmd;
+  cmd.kind        = command_kind::SCHEDULE_TIMER;
+  cmd.timer       = state;
+  cmd.generation  = state->generation_.load(std::memory_order_acquire);
+  cmd.expire_time = state->expire_time_.load(std::memory_order_relaxed);
+  cmd.duration    = timer_ctl->duration_;
+  cmd.cb          = std::move(timer_cb);
+  post_command(std::move(cmd));
 }
 void io_service::remove_timer(highp_timer* timer)
+{ // the command holds the timer state only, so the timer can be destroyed by caller once cancel returns
+  io_command cmd;
+  cmd.kind  = command_kind::CANCEL_TIMER;
+  cmd.timer = timer->state_;
+  post_command(std::move(cmd));
+}
+void io_service::post_command(io_command&& cmd)
+{
+  if (std::this_thread::get_id() == this->worker_id_)
+    return apply_command(cmd);
+
+  commands_.push(std::move(cmd));
+  this->wakeup();
+}
+void io_service::apply_command(io_command& cmd)
 {
-  std::lock_guard<std::recursive_mutex> lck(this->timer_queue_mtx_);
-  auto iter = this->find_timer(timer);
-  if (iter != timer_queue_.end())
+  switch (cmd.kind)
   {
-    timer_queue_.erase(iter);
-    if (!timer_queue_.empty())
-    {
-      this->sort_timers();
-      this->wakeup();
+    case command_kind::SCHEDULE_TIMER: {
+      if (cmd.generation != cmd.timer->generation_.load(std::memory_order_acquire))
+        break; // cancelled after posted
+      cmd.timer->duration_ = cmd.duration;
+      auto index           = cmd.timer->heap_index_;
+      if (index == (size_t)-1)
+        push_timer(timer_impl_t{cmd.expire_time, cmd.timer, std::move(cmd.cb)});
+      else
+      { // always replace timer_cb, and update the expire time
+        auto& timer_impl        = timer_queue_[index];
+        bool earlier            = cmd.expire_time < timer_impl.expire_time_;
+        timer_impl.expire_time_ = cmd.expire_time;
+        timer_impl.cb_          = std::move(cmd.cb);
+        if (earlier)
+          sift_up_timer(index);
+        else
+          sift_down_timer(index);
+      }
+      break;
+    }
+    case command_kind::CANCEL_TIMER:
+      if (cmd.timer->heap_index_ != (size_t)-1)
+        erase_timer(cmd.timer->heap_index_);
+      break;
+    case command_kind::OPEN_CHANNEL:
+      if (yasio__find(this->channel_ops_, cmd.ctx) == this->channel_ops_.end())
+        this->channel_ops_.push_back(cmd.ctx);
+      this->wait_duration_ = 0; // perform it at next loop without waiting, when posted by event callback
+      break;
+    case command_kind::PAUSE_READ:
+    case command_kind::RESUME_READ:
+      if (!cmd.transport_open())
+        break;
+      if (read_pausable(cmd.transport))
+        set_read_paused(cmd.transport, io_transport::READ_PAUSED_BY_USER, cmd.kind == command_kind::PAUSE_READ);
+      else
+        YASIO_KLOGW("[index: %d] the connection #%u %s read ignored, the datagrams routed by the udp server socket", cmd.transport->cindex(),
+                    cmd.transport->id_, cmd.kind == command_kind::PAUSE_READ ? "pause" : "resume");
+      break;
+    case command_kind::JOIN_GROUP:
+    case command_kind::LEAVE_GROUP:
+    case command_kind::PUBLISH:
+      apply_group_command(cmd);
+      break;
+    case command_kind::RELAY: {
+      // the header of incomplete packet already stripped, can't forward the original bytes to peer
+      auto stripped = [](transport_handle_t t) { return t->expected_size_ != -1 && t->ctx_->uparams_.initial_bytes_to_strip > 0; };
+      if (!cmd.transport_open() || !io_command::transport_open(cmd.peer, cmd.peer_id) || cmd.transport->relay_mode() || cmd.peer->relay_mode())
+        YASIO_KLOGE("relay failed, the connections not ok or already relayed!");
+      else if (stripped(cmd.transport) || stripped(cmd.peer))
+        YASIO_KLOGE("relay failed, the connections receiving a packet with header stripped!");
+      else
+      {
+        cmd.transport->relay_peer_ = cmd.peer;
+        cmd.peer->relay_peer_      = cmd.transport;
+        notify_transport(cmd.transport);
+        notify_transport(cmd.peer);
+      }
+      break;
+    }
+  }
+}
+void io_service::post_group_command(command_kind kind, transport_handle_t transport, cxx17::string_view group)
+{
+  io_command cmd;
+  cmd.kind         = kind;
+  cmd.transport    = transport;
+  cmd.transport_id = transport->id_;
+  cmd.group_op     = std::make_shared<io_group_op>();
+  cxx17::assign(cmd.group_op->group, group);
+  transport->get_service().post_command(std::move(cmd)); // may owned by worker loop
+}
+void io_service::apply_group_command(io_command& cmd)
+{
+  auto& op = *cmd.group_op;
+  switch (cmd.kind)
+  {
+    case command_kind::JOIN_GROUP:
+      if (cmd.transport_open())
+      {
+        auto& entry = *groups_.emplace(std::move(op.group), io_group_map::mapped_type{}).first;
+        if (entry.second.insert(cmd.transport).second)
+          cmd.transport->groups_.push_back(&entry);
+      }
+      break;
+    case command_kind::LEAVE_GROUP:
+      if (cmd.transport_open())
+      { // the closed transport already left all groups, see io_service::handle_close
+        auto it = groups_.find(op.group);
+        if (it != groups_.end() && it->second.erase(cmd.transport))
+        {
+          cmd.transport->groups_.erase(yasio__find(cmd.transport->groups_, &*it));
+          if (it->second.empty())
+            groups_.erase(it);
+        }
+      }
+      break;
+    case command_kind::PUBLISH: {
+      auto it = groups_.find(op.group);
+      if (it == groups_.end())
+        break;
+      for (auto transport : it->second)
+        transport->enqueue(transport->make_send_op(io_send_buffer{op.buffer}, completion_cb_t{op.handler}), false);
+      this->wait_duration_ = 0; // perform it at next loop without waiting, when posted by event callback
+      break;
     }
+    default:;
   }
 }
+void io_service::leave_groups(transport_handle_t transport)
+{
+  for (auto entry : transport->groups_)
+  {
+    entry->second.erase(transport);
+    if (entry->second.empty())
+      groups_.erase(groups_.find(entry->first));
+  }
+  transport->groups_.clear();
+}
+void io_service::process_commands()
+{
+  io_command cmd;
+  while (commands_.pop(cmd))
+    apply_command(cmd);
+}
+void io_service::push_timer(timer_impl_t&& timer)
+{
+  timer_queue_.push_back(std::move(timer));
+  sift_up_timer(timer_queue_.size() - 1);
+}
+timer_impl_t io_service::erase_timer(size_t index)
+{
+  timer_impl_t timer = std::move(timer_queue_[index]);
+  timer.timer_->heap_index_ = (size_t)-1;
+  auto last                 = timer_queue_.size() - 1;
+  if (index != last)
+  { // fill the hole with last timer, and restore the heap order
+    place_timer(index, std::move(timer_queue_[last]));
+    timer_queue_.pop_back();
+    if (index > 0 && timer_queue_[index].expire_time_ < timer_queue_[(index - 1) >> 2].expire_time_)
+      sift_up_timer(index);
+    else
+      sift_down_timer(index);
+  }
+  else
+    timer_queue_.pop_back();
+  return timer;
+}
+void io_service::sift_up_timer(size_t index)
+{
+  timer_impl_t timer = std::move(timer_queue_[index]);
+  while (index > 0)
+  {
+    auto parent = (index - 1) >> 2;
+    if (!(timer.expire_time_ < timer_queue_[parent].expire_time_))
+      break;
+    place_timer(index, std::move(timer_queue_[parent]));
+    index = parent;
+  }
+  place_timer(index, std::move(timer));
+}
+void io_service::sift_down_timer(size_t index)
+{
+  timer_impl_t timer = std::move(timer_queue_[index]);
+  const auto count   = timer_queue_.size();
+  for (;;)
+  {
+    auto first = (index << 2) + 1;
+    if (first >= count)
+      break;
+    auto earliest = first;
+    auto last     = (std::min)(first + 4, count);
+    for (auto child = first + 1; child < last; ++child)
+      if (timer_queue_[child].expire_time_ < timer_queue_[earliest].expire_time_)
+        earliest = child;
+    if (!(timer_queue_[earliest].expire_time_ < timer.expire_time_))
+      break;
+    place_timer(index, std::move(timer_queue_[earliest]));
+    index = earliest;
+  }
+  place_timer(index, std::move(timer));
+}
+void io_service::clear_timers()
+{
+  for (auto& timer_impl : timer_queue_)
+    timer_impl.timer_->heap_index_ = (size_t)-1;
+  timer_queue_.clear();
+}
 bool io_service::open_internal(io_channel* ctx)
 {
   if (ctx->state_ == io_base::state::CONNECTING || ctx->state_ == io_base::state::RESOLVING)
@@ -1883,12 +3618,10 @@ bool io_service::open_internal(io_channel* ctx)
 
   ++ctx->connect_id_;
 
-  this->channel_ops_mtx_.lock();
-  if (yasio__find(this->channel_ops_, ctx) == this->channel_ops_.end())
-    this->channel_ops_.push_back(ctx);
-  this->channel_ops_mtx_.unlock();
-
-  this->wakeup();
+  io_command cmd;
+  cmd.kind = command_kind::OPEN_CHANNEL;
+  cmd.ctx  = ctx;
+  post_command(std::move(cmd));
   return true;
 }
 bool io_service::close_internal(io_channel* ctx)
@@ -1906,30 +3639,21 @@ void io_service::process_timers()
   if (this->timer_queue_.empty())
     return;
 
-  std::lock_guard<std::recursive_mutex> lck(this->timer_queue_mtx_);
-
-  unsigned int n = 0; // the count expired loop timers
-  while (!this->timer_queue_.empty())
+  // the timers rescheduled with expire time <= now will fired at next loop
+  const auto now = this->current_time_;
+  while (!this->timer_queue_.empty() && timer_queue_.front().expire_time_ <= now)
   {
-    auto timer_ctl = timer_queue_.back().first;
-    if (timer_ctl->expired())
-    {
-      // fetch timer
-      auto timer_impl = std::move(timer_queue_.back());
-      timer_queue_.pop_back();
-
-      if (!timer_impl.second(*this))
-      { // reschedule if the timer want wait again
-        timer_ctl->expires_from_now();
-        timer_queue_.push_back(std::move(timer_impl));
-        ++n;
-      }
+    // fetch timer
+    auto timer_impl = erase_timer(0);
+    auto& timer     = *timer_impl.timer_;
+    auto generation = timer.generation_.load(std::memory_order_acquire);
+    if (!timer_impl.cb_(*this) && timer.heap_index_ == (size_t)-1 && timer.generation_.load(std::memory_order_acquire) == generation)
+    { // reschedule if the timer want wait again, and not rescheduled or cancelled by callback
+      timer_impl.expire_time_ = yasio::steady_clock_t::now() + timer.duration_;
+      timer.expire_time_.store(timer_impl.expire_time_, std::memory_order_relaxed);
+      push_timer(std::move(timer_impl));
     }
-    else
-      break;
   }
-  if (n)
-    this->sort_timers();
 }
 void io_service::process_deferred_events()
 {
@@ -1943,14 +3667,10 @@ highp_time_t io_service::get_timeout(highp_time_t usec)
   if (this->timer_queue_.empty())
     return usec;
 
-  std::lock_guard<std::recursive_mutex> lck(this->timer_queue_mtx_);
-  if (!this->timer_queue_.empty())
-  {
-    // microseconds
-    auto duration = timer_queue_.back().first->wait_duration();
-    if (std::chrono::microseconds(usec) > duration)
-      usec = duration.count();
-  }
+  // microseconds
+  auto duration = std::chrono::duration_cast<std::chrono::microseconds>(timer_queue_.front().expire_time_ - this->current_time_);
+  if (std::chrono::microseconds(usec) > duration)
+    usec = duration.count();
   return usec;
 }
 bool io_service::cleanup_channel(io_channel* ctx, bool clear_mask)
@@ -1958,7 +3678,7 @@ bool io_service::cleanup_channel(io_channel* ctx, bool clear_mask)
   ctx->clear_mutable_flags();
   bool bret = cleanup_io(ctx, clear_mask);
 #if defined(YASIO_ENABLE_PASSIVE_EVENT)
-  if (bret && yasio__testbits(ctx->properties_, YCM_SERVER))
+  if (bret && yasio__testbits(ctx->properties_, YCM_SERVER) && !this->host_)
     this->fire_event(ctx->index_, YEK_ON_CLOSE, 0, ctx, 1);
 #endif
   return bret;
@@ -2114,7 +3834,12 @@ int io_service::resolve(std::vector<ip::endpoint>& endpoints, const char* hostna
     return 0;
   return xxsocket::resolve_v4to6(endpoints, hostname, port);
 }
-void io_service::wakeup() { io_watcher_.wakeup(); }
+void io_service::wakeup()
+{
+  // only the first producer after the loop polled pays the syscall, the loop will process all posted works after woken
+  if (!wakeup_pending_.exchange(true, std::memory_order_acq_rel))
+    io_watcher_.wakeup();
+}
 const char* io_service::strerror(int error)
 {
   switch (error)
@@ -2221,9 +3946,31 @@ void io_service::set_option_internal(int opt, va_list ap) // lgtm [cpp/poorly-do
     case YOPT_S_DEFER_EVENT_CB:
       options_.on_defer_event_ = *va_arg(ap, defer_event_cb_t*);
       break;
+    case YOPT_S_BATCH_EVENT_CB:
+      options_.on_batch_event_ = *va_arg(ap, batch_event_cb_t*);
+      break;
+    case YOPT_S_EVENT_WATERMARKS:
+      options_.event_high_mark_     = (std::max)(va_arg(ap, int), 0);
+      options_.event_low_mark_      = yasio::clamp(va_arg(ap, int), 0, options_.event_high_mark_);
+      options_.event_mark_in_bytes_ = !!va_arg(ap, int);
+      break;
+    case YOPT_S_DISPATCH_THREADS:
+      options_.dispatch_threads_    = (std::max)(va_arg(ap, int), 0);
+      options_.dispatch_by_channel_ = !!va_arg(ap, int);
+      break;
     case YOPT_S_FORWARD_PACKET:
       options_.forward_packet_ = !!va_arg(ap, int);
       break;
+    case YOPT_S_READY_LIST:
+      options_.ready_list_ = !!va_arg(ap, int);
+      break;
+    case YOPT_S_UDP_BATCH:
+      options_.udp_batch_ = yasio::clamp(va_arg(ap, int), 1, YASIO_MAX_UDP_BATCH);
+      break;
+    case YOPT_S_IO_LOOPS:
+      options_.io_loops_         = (std::max)(va_arg(ap, int), 1);
+      options_.io_loops_balance_ = va_arg(ap, int);
+      break;
 #if defined(_WIN32)
     case YOPT_S_HRES_TIMER:
       options_.hres_timer_ = !!va_arg(ap, int);
@@ -2334,6 +4081,37 @@ void io_service::set_option_internal(int opt, va_list ap) // lgtm [cpp/poorly-do
         channel->disable_multicast();
       break;
     }
+    case YOPT_C_ACCEPT_PARAMS: {
+      auto channel = channel_at(static_cast<size_t>(va_arg(ap, int)));
+      if (channel)
+      {
+        int backlog           = va_arg(ap, int);
+        channel->backlog_     = backlog > 0 ? backlog : YASIO_SOMAXCONN;
+        channel->max_accepts_ = va_arg(ap, int);
+      }
+      break;
+    }
+    case YOPT_C_ZEROCOPY: {
+      auto channel = channel_at(static_cast<size_t>(va_arg(ap, int)));
+      if (channel)
+        channel->zerocopy_threshold_ = (std::max)(va_arg(ap, int), 0);
+      break;
+    }
+    case YOPT_C_RING_BUFFER: {
+      auto channel = channel_at(static_cast<size_t>(va_arg(ap, int)));
+      if (channel)
+        channel->ring_capacity_ = (std::max)(va_arg(ap, int), 0);
+      break;
+    }
+    case YOPT_C_SEND_WATERMARKS: {
+      auto channel = channel_at(static_cast<size_t>(va_arg(ap, int)));
+      if (channel)
+      {
+        channel->send_high_mark_ = (std::max)(va_arg(ap, int), 0);
+        channel->send_low_mark_  = (std::min)((std::max)(va_arg(ap, int), 0), channel->send_high_mark_);
+      }
+      break;
+    }
     case YOPT_C_MOD_FLAGS: {
       auto channel = channel_at(static_cast<size_t>(va_arg(ap, int)));
       if (channel)
@@ -37,6 +37,8 @@ SOFTWARE.
 #include <chrono>
 #include <functional>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include "yasio/sz.hpp"
 #include "yasio/config.hpp"
 #include "yasio/singleton.hpp"
@@ -49,6 +51,11 @@ SOFTWARE.
 #include "yasio/byte_buffer.hpp"
 #include "yasio/xxsocket.hpp"
 #include "yasio/io_watcher.hpp"
+#include "yasio/impl/fd_table.hpp"
+#include "yasio/impl/mirrored_buffer.hpp"
+#include "yasio/impl/recv_buffer_pool.hpp"
+#include "yasio/impl/mpsc_queue.hpp"
+#include "yasio/impl/dispatch_pool.hpp"
 
 #if !defined(YASIO_USE_CARES)
 #  include "yasio/shared_mutex.hpp"
@@ -191,6 +198,59 @@ enum
   // params: hres: int(0)
   YOPT_S_HRES_TIMER,
 
+  // Set whether the event loop only visit transports which have io events or pending operations
+  // params: ready_list: int(0)
+  // remarks:
+  //   a. Idle transports cost nothing per event loop, useful for service with a lot of connections
+  //   b. Should be set before io_service start
+  YOPT_S_READY_LIST,
+
+  // Set count of event loop threads, the accepted connections of tcp server channels
+  // will be distributed across them
+  // params: loops: int(1), balance: int(YLB_ROUND_ROBIN)
+  // remarks:
+  //   a. Should be set before io_service start
+  //   b. The events of all loops are delivered to this service, the forward packet and
+  //      defer event callbacks may be invoked at any loop thread concurrently
+  //   c. io_transport::get_context returns the mirrored channel owned by the loop
+  YOPT_S_IO_LOOPS,
+
+  // Set batch size of udp recvmmsg/sendmmsg
+  // params: batch_size: int(1)
+  // remarks:
+  //   a. The batch size is clamped to [1, YASIO_MAX_UDP_BATCH], 1: one datagram per syscall
+  //   b. Works for udp server channel and connected udp transports, linux only
+  YOPT_S_UDP_BATCH,
+
+  // Set batch event callback, the events dispatched at once per io_service::dispatch call
+  // params: func:batch_event_cb_t*
+  // remarks:
+  //   a. this callback will be invoke at io_service::dispatch caller thread, with at most max_count events
+  //   b. takes precedence over YOPT_S_EVENT_CB for deferred events, the forward packets still
+  //      deliver to the event callback at network thread
+  //   c. the events are destroyed after callback returns unless moved out by callback
+  YOPT_S_BATCH_EVENT_CB,
+
+  // Set count of dispatcher threads, the deferred events dispatched by them instead of io_service::dispatch
+  // params: threads:int(0), by_channel:int(0)
+  // remarks:
+  //   a. The events hashed by transport id to a dispatcher, or by channel index when by_channel is 1,
+  //      so the events of one connection always dispatched in order, and a slow handler only stalls
+  //      the connections hashed to same dispatcher
+  //   b. The event callbacks may be invoked at any dispatcher thread concurrently
+  //   c. Should be set before io_service start, 0: disabled
+  YOPT_S_DISPATCH_THREADS,
+
+  // Set the watermarks of deferred events not dispatched yet, in events count or packet bytes
+  // params: high:int(0), low:int(0), in_bytes:int(0)
+  // remarks:
+  //   a. When the queued events reach high, the transports which still receiving stop read polling,
+  //      and resume after the queued events drop to low, the remain data held by kernel socket buffer
+  //      and tcp flow control, the datagrams exceed udp socket buffer are dropped by kernel, except the
+  //      udp server sessions routed by user(win32 or multicast), see io_service::pause_read
+  //   b. 0: disabled, low is clamped to [0, high]
+  YOPT_S_EVENT_WATERMARKS,
+
   // Sets channel length field based frame decode function, native C++ ONLY
   // params: index:int, func:decode_len_fn_t*
   YOPT_C_UNPACK_FN = 101,
@@ -286,6 +346,41 @@ enum
   // params: index:int, no_bswap:int(0)
   YOPT_C_UNPACK_NO_BSWAP,
 
+  // Sets tcp server channel accept params
+  // params: index:int, backlog:int(YASIO_SOMAXCONN), max_accepts:int(0)
+  // remarks:
+  //   a. The backlog takes effect at next open of channel
+  //   b. The max_accepts is max connections accepted per event loop, 0: until EAGAIN
+  //   c. The backlog <= 0 is treated as YASIO_SOMAXCONN
+  YOPT_C_ACCEPT_PARAMS,
+
+  // Sets tcp channel zero-copy send threshold, the send op which size >= threshold will be sent with MSG_ZEROCOPY
+  // params: index:int, threshold:int(0)
+  // remarks:
+  //   a. 0: disabled, linux 4.14+ only, the kernel recommends threshold >= 10KB
+  //   b. The completion_cb_t of the op fires after the kernel release its pages
+  //   c. Automatically fallback to copy once the kernel reports data copied, i.e. loopback
+  YOPT_C_ZEROCOPY,
+
+  // Sets tcp channel receive ring buffer capacity, unpack frames in the ring buffer without copy
+  // params: index:int, capacity:int(0)
+  // remarks:
+  //   a. 0: disabled, the capacity must >= max_frame_length of YOPT_C_UNPACK_PARAMS, and
+  //      ignored when YOPT_S_FORWARD_PACKET enabled
+  //   b. The complete frames dispatched at io thread as io_event::packet_view immediately, the
+  //      view invalid after event callback returns, same as YOPT_S_FORWARD_PACKET
+  //   c. linux: the ring pages mapped twice, partial frame never compacted
+  YOPT_C_RING_BUFFER,
+
+  // Sets channel send queue watermarks in bytes, for proxy or fan-out flow control
+  // params: index:int, high:int(0), low:int(0)
+  // remarks:
+  //   a. When the bytes queued by write or write_file of a transport reach high, the YEK_ON_SEND_HIGH fired once,
+  //      and the YEK_ON_SEND_LOW fired after the queued bytes drop to low, the event status is the
+  //      queued bytes, i.e. pause_read the source when high, and resume_read it when low
+  //   b. 0: disabled, low is clamped to [0, high]
+  YOPT_C_SEND_WATERMARKS,
+
   // Change 4-tuple association for io_transport_udp
   // params: transport:transport_handle_t
   // remarks: only works for udp client transport
@@ -334,6 +429,28 @@ enum
      https://docs.microsoft.com/en-us/windows/win32/winsock/using-so-reuseaddr-and-so-exclusiveaddruse
   */
   YCF_EXCLUSIVEADDRUSE = 1 << 10,
+
+  /* For tcp server, open a SO_REUSEPORT listener per event loop on the same endpoint, see YOPT_S_IO_LOOPS,
+     the kernel distributes incoming connections across them, linux 3.9+, bsd */
+  YCF_REUSEPORT_LB = 1 << 11,
+
+  /* For tcp server with YCF_REUSEPORT_LB, attach a cBPF program which steers incoming connections to the
+     listener indexed by cpu % loops, linux 4.5+ only */
+  YCF_REUSEPORT_CBPF = 1 << 12,
+
+  /* For udp and kcp, send the queued datagrams to same destination as one UDP_SEGMENT(GSO) message,
+     the datagram size should not exceed path mtu, linux 4.18+ only */
+  YCF_UDP_GSO = 1 << 13,
+
+  /* For udp and kcp, receive the coalesced datagrams with UDP_GRO and split to origin ones, linux 5.0+ only */
+  YCF_UDP_GRO = 1 << 14,
+};
+
+// the balance policies of event loops, see YOPT_S_IO_LOOPS
+enum
+{
+  YLB_ROUND_ROBIN,
+  YLB_LEAST_LOADED,
 };
 
 // event kinds
@@ -342,6 +459,8 @@ enum
   YEK_ON_OPEN = 1,
   YEK_ON_CLOSE,
   YEK_ON_PACKET,
+  YEK_ON_SEND_HIGH, // the send queue reach high watermark, see YOPT_C_SEND_WATERMARKS
+  YEK_ON_SEND_LOW,  // the send queue drop to low watermark after high
   YEK_CONNECT_RESPONSE = YEK_ON_OPEN,   // implicit deprecated alias
   YEK_CONNECTION_LOST  = YEK_ON_CLOSE,  // implicit deprecated alias
   YEK_PACKET           = YEK_ON_PACKET, // implicit deprecated alias
@@ -361,6 +480,7 @@ enum
 class highp_timer;
 class io_send_op;
 class io_sendto_op;
+class io_sendfile_op;
 class io_event;
 class io_channel;
 class io_transport;
@@ -378,19 +498,37 @@ typedef std::shared_ptr<xxsocket> xxsocket_ptr;
 
 typedef std::unique_ptr<io_send_op> send_op_ptr;
 typedef std::unique_ptr<io_event> event_ptr;
+typedef std::shared_ptr<const sbyte_buffer> shared_buffer_ptr;
+typedef std::unordered_map<std::string, std::unordered_set<io_transport*>> io_group_map;
 typedef std::shared_ptr<highp_timer> highp_timer_ptr;
 
 typedef std::function<bool(io_service&)> timer_cb_t;
 typedef std::function<void(io_service&)> timerv_cb_t;
 typedef std::function<void(event_ptr&&)> event_cb_t;
 typedef std::function<bool(event_ptr&)> defer_event_cb_t;
+typedef std::function<void(event_ptr* events, size_t count)> batch_event_cb_t;
 typedef std::function<void(int, size_t)> completion_cb_t;
 typedef std::function<int(void* d, int n)> decode_len_fn_t;
 typedef std::function<int(std::vector<ip::endpoint>&, const char*, unsigned short)> resolv_fn_t;
 typedef std::function<void(const char*)> print_fn_t;
 typedef std::function<void(int level, const char*)> print_fn2_t;
 
-typedef std::pair<highp_timer*, timer_cb_t> timer_impl_t;
+// the state of highp_timer shared with the timer heap and the commands of io_service, so the timer can be
+// destroyed once cancel returns, while the commands posted by it still queued
+struct highp_timer_state {
+  std::atomic<std::chrono::time_point<yasio::steady_clock_t>> expire_time_{std::chrono::time_point<yasio::steady_clock_t>{}};
+  std::atomic<unsigned int> generation_{0}; // increased by cancel, the schedules posted before it are discarded
+  std::chrono::microseconds duration_{};    // io thread only, the duration to wait again
+  size_t heap_index_ = (size_t)-1;          // io thread only, the index in timer heap of io_service, -1: not scheduled
+};
+typedef std::shared_ptr<highp_timer_state> highp_timer_state_ptr;
+
+// the entry of io_service timer heap, the expire time cached as heap key
+struct timer_impl_t {
+  std::chrono::time_point<yasio::steady_clock_t> expire_time_;
+  highp_timer_state_ptr timer_;
+  timer_cb_t cb_;
+};
 
 // alias, for compatible purpose only
 typedef highp_timer deadline_timer;
@@ -424,18 +562,20 @@ struct io_hostent {
 };
 
 class YASIO_API highp_timer {
+  friend class io_service;
+
 public:
-  highp_timer(io_service& service) : service_(service){};
+  highp_timer(io_service& service) : service_(service), state_(std::make_shared<highp_timer_state>()){};
   highp_timer(const highp_timer&)            = delete;
   highp_timer(highp_timer&&)                 = delete;
   highp_timer& operator=(const highp_timer&) = delete;
   void expires_from_now(const std::chrono::microseconds& duration)
   {
-    this->duration_    = duration;
-    this->expire_time_ = yasio::steady_clock_t::now() + this->duration_;
+    this->duration_ = duration;
+    this->expires_from_now();
   }
 
-  void expires_from_now() { this->expire_time_ = yasio::steady_clock_t::now() + this->duration_; }
+  void expires_from_now() { state_->expire_time_.store(yasio::steady_clock_t::now() + this->duration_, std::memory_order_relaxed); }
 
   // Wait timer timeout once.
   void async_wait_once(timerv_cb_t cb)
@@ -456,7 +596,7 @@ public:
   //        false: wait again after expired
   YASIO__DECL void async_wait(timer_cb_t);
 
-  // Cancel the timer
+  // Cancel the timer, it's not blocking, and the timer can be destroyed once cancel returns
   YASIO__DECL void cancel();
 
   // Check if timer is expired?
@@ -466,8 +606,10 @@ public:
   YASIO__DECL std::chrono::microseconds wait_duration() const;
 
   io_service& service_;
-  std::chrono::microseconds duration_                         = {};
-  std::chrono::time_point<yasio::steady_clock_t> expire_time_ = {};
+  std::chrono::microseconds duration_ = {};
+
+private:
+  highp_timer_state_ptr state_;
 };
 
 struct YASIO_API io_base {
@@ -489,7 +631,7 @@ struct YASIO_API io_base {
   };
   io_base() : error_(0), state_(state::CLOSED), opmask_(0)
   {
-    static unsigned int s_object_id = 0;
+    static std::atomic<unsigned int> s_object_id{0};
     this->id_                       = ++s_object_id;
   }
   virtual ~io_base() {}
@@ -607,6 +749,20 @@ private:
   int index_;
   int socktype_ = 0;
 
+  // tcp server only, the listen backlog and max connections accepted per event loop, 0: until EAGAIN
+  int backlog_     = YASIO_SOMAXCONN;
+  int max_accepts_ = 0;
+
+  // tcp only, the min send op size to use MSG_ZEROCOPY, 0: disabled
+  int zerocopy_threshold_ = 0;
+
+  // tcp only, the capacity of receive ring buffer, 0: disabled
+  int ring_capacity_ = 0;
+
+  // the send queue watermarks in bytes, 0: disabled
+  int send_high_mark_ = 0;
+  int send_low_mark_  = 0;
+
   // The timer for check resolve & connect timeout
   highp_timer timer_;
 
@@ -666,10 +822,18 @@ public:
     data_ = const_buffer;
     size_ = const_buffer_size;
   }
+  // the immutable buffer shared with other ops, released after the last op destroyed
+  explicit io_send_buffer(shared_buffer_ptr shared_buffer)
+  {
+    data_          = shared_buffer->data();
+    size_          = shared_buffer->size();
+    shared_buffer_ = std::move(shared_buffer);
+  }
   io_send_buffer(const io_send_buffer&) = delete;
   io_send_buffer(io_send_buffer&& rhs) YASIO__NOEXCEPT
   {
     mutable_buffer_ = std::move(rhs.mutable_buffer_);
+    shared_buffer_  = std::move(rhs.shared_buffer_);
     data_           = rhs.data_;
     size_           = rhs.size_;
   }
@@ -681,13 +845,14 @@ public:
 
 private:
   yasio::sbyte_buffer mutable_buffer_;
+  shared_buffer_ptr shared_buffer_;
 
   const char* data_;
   size_t size_;
 };
 
 // for tcp transport only
-class YASIO_API io_send_op {
+class YASIO_API io_send_op : public mpsc_node {
 public:
   io_send_op(io_send_buffer&& buffer, completion_cb_t&& handler) : offset_(0), buffer_(std::move(buffer)), handler_(std::move(handler)) {}
   virtual ~io_send_op() {}
@@ -698,6 +863,14 @@ public:
 
   YASIO__DECL virtual int perform(transport_handle_t transport, const void* buf, int n, int& error);
 
+  virtual const ip::endpoint* destination() const { return nullptr; }
+
+  // whether the op is io_sendfile_op, which sends file content instead of buffer_
+  virtual bool is_file() const { return false; }
+
+  // the bytes to send, counted by the send queue watermarks, see YOPT_C_SEND_WATERMARKS
+  virtual size_t size() const { return buffer_.size(); }
+
 #if !defined(YASIO_DISABLE_OBJECT_POOL)
   DEFINE_CONCURRENT_OBJECT_POOL_ALLOCATION(io_send_op, 128)
 #endif
@@ -711,16 +884,80 @@ public:
   {}
 
   YASIO__DECL int perform(transport_handle_t transport, const void* buf, int n, int& error) override;
+
+  const ip::endpoint* destination() const override { return std::addressof(destination_); }
 #if !defined(YASIO_DISABLE_OBJECT_POOL)
   DEFINE_CONCURRENT_OBJECT_POOL_ALLOCATION(io_sendto_op, 128)
 #endif
   ip::endpoint destination_;
 };
 
+// for stream transport only, see io_service::write_file
+class YASIO_API io_sendfile_op : public io_send_op {
+public:
+  enum
+  {
+    mode_sendfile, // linux: sendfile from regular file to socket
+    mode_splice,   // linux: splice from regular file to socket through a pipe, when sendfile not supported by filesystem
+    mode_read,     // read file to chunk, and send it by transport primitive, i.e. ssl transport
+  };
+  YASIO__DECL io_sendfile_op(int fd, bool owns_fd, int64_t offset, size_t length, int mode, completion_cb_t&& handler);
+  YASIO__DECL ~io_sendfile_op();
+
+  bool is_file() const override { return true; }
+
+  size_t size() const override { return length_; }
+
+#if !defined(YASIO_DISABLE_OBJECT_POOL)
+  DEFINE_CONCURRENT_OBJECT_POOL_ALLOCATION(io_sendfile_op, 16)
+#endif
+  int fd_;
+  bool owns_fd_;
+  int mode_;
+  int64_t file_offset_; // the start offset of file
+  size_t length_;       // the bytes to send
+  int pipe_[2];         // mode_splice only
+  size_t piped_;        // mode_splice only, the bytes in pipe not sent yet
+  sbyte_buffer chunk_;  // mode_read only
+  size_t chunk_offset_; // mode_read only
+};
+
+// The relay state of one direction, from the owner transport to it's peer, see io_service::relay
+class YASIO_API io_relay_pipe {
+public:
+  YASIO__DECL io_relay_pipe();
+  YASIO__DECL ~io_relay_pipe();
+
+  bool is_valid() const;
+
+  // move bytes from socket to pipe, returns: > 0: bytes moved, 0: EOF, < 0: error
+  YASIO__DECL int fill(xxsocket* s);
+
+  // move bytes from pipe to socket, returns: >= 0: bytes moved, < 0: error
+  YASIO__DECL int flush(xxsocket* s);
+
+#if YASIO__HAS_SENDFILE
+  int fds_[2]; // linux: the bytes spliced from source socket to peer socket through the pipe without copy
+#else
+  sbyte_buffer buffer_; // other platforms: copy the bytes with user buffer
+  size_t offset_ = 0;
+#endif
+  size_t pending_ = 0;     // the bytes in pipe not sent to peer yet
+  uint64_t bytes_ = 0;     // the total bytes sent to peer
+  bool eof_       = false; // the source reach EOF
+  bool shutdown_  = false; // the EOF propagated to peer by shutdown(SD_SEND)
+};
+#if YASIO__HAS_SENDFILE
+inline bool io_relay_pipe::is_valid() const { return fds_[0] != -1; }
+#else
+inline bool io_relay_pipe::is_valid() const { return true; }
+#endif
+
 class io_transport : public io_base {
   friend class io_service;
   friend class io_send_op;
   friend class io_sendto_op;
+  friend class io_sendfile_op;
   friend class io_event;
 
   io_transport(const io_transport&) = delete;
@@ -733,8 +970,13 @@ public:
 
   io_channel* get_context() const { return ctx_; }
 
+  // The bytes relayed from this transport to it's peer, see io_service::relay
+  uint64_t relayed_bytes() const { return relay_ ? relay_->bytes_ : 0; }
+
   virtual ~io_transport()
   {
+    offset_ = 0;
+    return_buffer();
     ctx_ = nullptr;
     send_queue_.clear();
   }
@@ -752,7 +994,13 @@ protected:
   YASIO__DECL const print_fn2_t& __get_cprint() const;
 
   // Call at user thread
-  YASIO__DECL virtual int write(io_send_buffer&&, completion_cb_t&&);
+  YASIO__DECL int write(io_send_buffer&&, completion_cb_t&&);
+  // Call at user thread, create the op of write
+  YASIO__DECL virtual send_op_ptr make_send_op(io_send_buffer&&, completion_cb_t&&);
+
+  // Call at user thread, queue the op, all kinds of ops share the send_queue_ to keep order
+  // the wakeup can be deferred by caller to post multiple ops at once, see io_service::broadcast
+  YASIO__DECL void enqueue(send_op_ptr&& op, bool wakeup = true);
 
   // Call at user thread
   virtual int write_to(io_send_buffer&&, const ip::endpoint&, completion_cb_t&&)
@@ -763,6 +1011,24 @@ protected:
 
   YASIO__DECL int call_read(void* data, int size, int revent, int& error);
   YASIO__DECL int call_write(io_send_op*, int& error);
+  // send the file content of front op, stream transport only
+  YASIO__DECL int call_sendfile(io_sendfile_op*, int& error);
+  // gather the queued send ops to one sendv, tcp only
+  YASIO__DECL int call_writev(int& error);
+#if YASIO__HAS_ZEROCOPY
+  // send the front op with MSG_ZEROCOPY, tcp only
+  YASIO__DECL int call_write_zerocopy(io_send_op*, int& error);
+  // reap the zero-copy completions from socket error queue, and fire the completion_cb_t of released ops
+  YASIO__DECL void reap_zerocopy();
+  // complete the ops still wait for zero-copy completions with error when closing, the completions never arrive after close
+  YASIO__DECL void abort_zerocopy(int error);
+  bool zerocopy_pending() const { return zc_next_ != zc_done_ || !zc_ops_.empty(); }
+#endif
+#if YASIO__HAS_MMSG
+  // send the queued datagrams with one sendmmsg, udp only, the datagrams to same destination
+  // merged to one message when YCF_UDP_GSO set
+  YASIO__DECL int call_sendmmsg(int& error);
+#endif
   YASIO__DECL void complete_op(io_send_op*, int error);
 
   // Call at io_service
@@ -778,8 +1044,15 @@ protected:
 
   bool is_valid() const { return ctx_ != nullptr; }
 
-  char buffer_[yasio__max_rcvbuf]; // recv buffer, 64K
-  int offset_ = 0;                 // recv buffer offset
+  // Borrow the 64K recv buffer from io_service, the pending bytes kept
+  YASIO__DECL char* borrow_buffer();
+  // Return the recv buffer to io_service when no pending bytes, otherwise shrink it to the
+  // smallest size class which holds the pending bytes of partial frame
+  YASIO__DECL void return_buffer();
+
+  char* buffer_     = nullptr; // recv buffer, borrowed only while reading or partial frame pending
+  int buffer_class_ = -1;      // the size class of recv buffer, see recv_buffer_pool
+  int offset_       = 0;       // recv buffer offset
 
   int expected_size_ = -1;
   sbyte_buffer expected_packet_;
@@ -789,7 +1062,65 @@ protected:
   std::function<int(const void*, int, const ip::endpoint*, int&)> write_cb_;
   std::function<int(void*, int, int, int&)> read_cb_;
 
+#if defined(YASIO_USE_SPSC_QUEUE) || defined(YASIO_USE_LOCKED_SEND_QUEUE)
   privacy::concurrent_queue<send_op_ptr> send_queue_;
+#else
+  privacy::intrusive_concurrent_queue<io_send_op> send_queue_;
+#endif
+
+  // The ready list states, see YOPT_S_READY_LIST
+  unsigned int visit_stamp_ = 0;
+  bool busy_                = false; // in io_service::busy_transports_, service thread only
+  std::atomic<bool> pending_{false}; // in io_service::pending_transports_
+
+  // The slots in the transport lists of service, for O(1) removal at close, see io_service::handle_close
+  size_t slot_         = 0; // io_service::transports_
+  size_t busy_slot_    = 0; // io_service::busy_transports_, valid when busy_
+  size_t pending_slot_ = 0; // io_service::pending_transports_, guarded by pending_transports_mtx_
+  size_t paused_slot_  = 0; // io_service::paused_transports_, valid when READ_PAUSED_BY_BACKPRESSURE
+
+  // The reasons of read polling paused, see io_service::pause_read, YOPT_S_EVENT_WATERMARKS and io_service::relay
+  enum : uint8_t
+  {
+    READ_PAUSED_BY_USER         = 1,
+    READ_PAUSED_BY_BACKPRESSURE = 2,
+    READ_PAUSED_BY_RELAY        = 4, // the relay pipe is full or the source reach EOF
+  };
+  uint8_t read_paused_ = 0;
+
+  // The send queue watermarks states, see YOPT_C_SEND_WATERMARKS
+  int send_high_mark_   = 0;     // 0: disabled
+  int send_low_mark_    = 0;
+  bool send_above_high_ = false; // the YEK_ON_SEND_HIGH fired, service thread only
+  std::atomic<int64_t> queued_bytes_{0};
+
+  // The UDP_SEGMENT not supported by route device or datagram exceed path mtu, see YCF_UDP_GSO
+  bool gso_off_ = false;
+
+  // The receive ring buffer, see YOPT_C_RING_BUFFER
+  std::unique_ptr<mirrored_buffer> rbuf_;
+
+  // The relay states, see io_service::relay
+  io_transport* relay_peer_ = nullptr; // assigned by the relay command at io thread, and cleared when peer closed
+  std::unique_ptr<io_relay_pipe> relay_;
+  bool relay_mode() const { return relay_peer_ != nullptr || relay_ != nullptr; }
+
+  // The groups joined, see io_service::join_group, service thread only
+  std::vector<io_group_map::value_type*> groups_;
+
+#if YASIO__HAS_ZEROCOPY
+  // The MSG_ZEROCOPY states, see YOPT_C_ZEROCOPY
+  struct zerocopy_op {
+    send_op_ptr op;
+    uint32_t seq; // the op released when all zero-copy sends before seq completed
+    int error;
+  };
+  int zc_threshold_ = 0;            // 0: disabled
+  uint32_t zc_next_ = 0;            // the seq of next zero-copy send
+  uint32_t zc_done_ = 0;            // all zero-copy sends before it completed
+  std::deque<zerocopy_op> zc_ops_;  // the sent ops wait for zero-copy completions, keep completion order
+  std::vector<std::pair<uint32_t, uint32_t>> zc_ranges_; // the out of order completed ranges
+#endif
 };
 
 class YASIO_API io_transport_tcp : public io_transport {
@@ -826,7 +1157,7 @@ protected:
   YASIO__DECL void connect();
   YASIO__DECL void disconnect();
 
-  YASIO__DECL int write(io_send_buffer&&, completion_cb_t&&) override;
+  YASIO__DECL send_op_ptr make_send_op(io_send_buffer&&, completion_cb_t&&) override;
   YASIO__DECL int write_to(io_send_buffer&&, const ip::endpoint&, completion_cb_t&&) override;
 
   YASIO__DECL void set_primitives() override;
@@ -864,7 +1195,15 @@ protected:
 
   int interval() const { return kcp_->interval * std::milli::den; }
 
-  sbyte_buffer rawbuf_; // the low level raw buffer
+#if YASIO__HAS_MMSG
+  // collect the kcp output datagrams, flush them with one UDP_SEGMENT message, see YCF_UDP_GSO
+  YASIO__DECL int gso_output(const char* buf, int len);
+  YASIO__DECL void gso_flush();
+
+  sbyte_buffer gso_buffer_;
+  int gso_size_ = 0;
+#endif
+
   ikcpcb* kcp_{nullptr};
   IUINT32 expire_time_{0}; // the next expire time(ms) to call ikcp_update
   std::function<int(const void*, int, const ip::endpoint*, int&)> underlaying_write_cb_;
@@ -1080,6 +1419,12 @@ public:
 
   // close transport
   YASIO__DECL void close(transport_handle_t);
+
+  // pause or resume the read polling of transport, the unread data held by kernel socket buffer
+  // and tcp flow control, safe to call at any thread, see YOPT_C_SEND_WATERMARKS
+  // ignored for the udp server sessions routed by user(win32 or multicast), which receive by the server socket
+  YASIO__DECL void pause_read(transport_handle_t);
+  YASIO__DECL void resume_read(transport_handle_t);
   // close channel
   YASIO__DECL void close(int index);
 
@@ -1102,6 +1447,38 @@ public:
   YASIO__DECL int write(transport_handle_t thandle, sbyte_buffer buffer, completion_cb_t completion_handler = nullptr);
   YASIO__DECL int forward(transport_handle_t thandle, const void* buf, size_t len, completion_cb_t completion_handler);
 
+  /*
+  ** summary: Write one immutable buffer to multiple transports without copy, i.e. the state snapshot of game server
+  ** retval: the number of transports the buffer queued to, the transports not open are skipped
+  ** params:
+  **        'thandles': the transports to write, could be tcp/udp/kcp, may owned by different worker loops
+  **        'buffer': the shared buffer, referenced by the send ops and released after the last op completed
+  **        'handler': send finish callback, invoked once per transport
+  ** remark:
+  **        + The io_service or worker loops which own the transports wakeup once after all ops queued
+  */
+  YASIO__DECL int broadcast(const transport_handle_t* thandles, size_t count, shared_buffer_ptr buffer, completion_cb_t completion_handler = nullptr);
+  int broadcast(const std::vector<transport_handle_t>& thandles, shared_buffer_ptr buffer, completion_cb_t completion_handler = nullptr)
+  {
+    return broadcast(thandles.data(), thandles.size(), std::move(buffer), std::move(completion_handler));
+  }
+
+  /*
+  ** summary: The named groups of transports, i.e. rooms or topics, for publish-subscribe
+  ** params:
+  **        'thandle': the transport to join or leave the group
+  **        'group': the group name, the group created by first join, and removed after last leave
+  **        'buffer': the shared buffer to publish, see broadcast
+  **        'handler': send finish callback, invoked once per transport
+  ** remark:
+  **        + Safe to call at any thread, the groups maintained by the io thread which owns the transports,
+  **          the worker loops have their own groups, and the publish fans out at each loop
+  **        + The transport leaves all groups automatically when closed
+  */
+  YASIO__DECL void join_group(transport_handle_t thandle, cxx17::string_view group);
+  YASIO__DECL void leave_group(transport_handle_t thandle, cxx17::string_view group);
+  YASIO__DECL void publish(cxx17::string_view group, shared_buffer_ptr buffer, completion_cb_t completion_handler = nullptr);
+
   /*
    ** Summary: Write data to unconnected UDP transport with specified address.
    ** retval: < 0: failed
@@ -1116,6 +1493,42 @@ public:
   YASIO__DECL int write_to(transport_handle_t thandle, sbyte_buffer buffer, const ip::endpoint& to, completion_cb_t completion_handler = nullptr);
   YASIO__DECL int forward_to(transport_handle_t thandle, const void* buf, size_t len, const ip::endpoint& to, completion_cb_t completion_handler);
 
+  /*
+  ** summary: Write file content to a TCP or UDS transport without reading it to user memory
+  ** retval: < 0: failed, 0: queued
+  ** params:
+  **        'thandle': the transport to write, stream transport only
+  **        'fd'/'path': the file to write, the fd must keep open until completion, the path opened/closed by yasio
+  **        'offset': the start offset of file
+  **        'length': the bytes to write, 0: until end of file
+  **        'completion_handler': send finish callback, the error is yasio::errc::eof when file truncated while sending
+  ** remark:
+  **        + The file op queued in order with other write ops, and respects the socket send buffer like them
+  **        + linux: use sendfile, or splice through a pipe when filesystem doesn't support sendfile
+  **        + SSL/other platforms: read file by YASIO_SENDFILE_CHUNK_SIZE chunks and send them
+  **        + The regular file only, the non-regular file, i.e. pipe, is refused
+  */
+  YASIO__DECL int write_file(transport_handle_t thandle, int fd, int64_t offset = 0, int64_t length = 0, completion_cb_t completion_handler = nullptr);
+  YASIO__DECL int write_file(transport_handle_t thandle, const char* path, int64_t offset = 0, int64_t length = 0,
+                             completion_cb_t completion_handler = nullptr);
+
+  /*
+  ** summary: Relay the bytes between two TCP transports in kernel side, i.e. the proxy between client and backend
+  ** retval: < 0: failed, 0: the pair posted to the io thread owning the transports
+  ** params:
+  **        'thandle', 'peer': the transports to pair, stream transports of same io loop and without SSL
+  ** remark:
+  **        + The transports paired at io thread, the pair ignored with error log when any of them closed,
+  **          already relayed, or receiving a packet which header stripped by YOPT_C_UNPACK_STRIP at that time
+  **        + The received bytes not dispatched as packet will be forwarded to peer first, and the further
+  **          bytes forwarded without YEK_ON_PACKET
+  **        + linux: splice through a pipe per direction, other platforms: copy with user buffer
+  **        + The read of one side paused when the pipe to peer is full
+  **        + The EOF of one side propagated to peer by shutdown(SD_SEND), the pair closed when both directions
+  **          reach EOF or any error occurred, see io_transport::relayed_bytes
+  */
+  YASIO__DECL int relay(transport_handle_t thandle, transport_handle_t peer);
+
   // The highp_timer support, !important, the callback is called on the thread of io_service
   YASIO__DECL highp_timer_ptr schedule(const std::chrono::microseconds& duration, timer_cb_t);
 
@@ -1131,15 +1544,64 @@ private:
   YASIO__DECL void schedule_timer(highp_timer*, timer_cb_t&&);
   YASIO__DECL void remove_timer(highp_timer*);
 
-  std::vector<timer_impl_t>::iterator find_timer(highp_timer* key)
+  // The 4-ary min heap of timers, the highp_timer holds it's index, O(log4(n)) schedule & cancel
+  YASIO__DECL void push_timer(timer_impl_t&& timer);
+  YASIO__DECL timer_impl_t erase_timer(size_t index);
+  YASIO__DECL void sift_up_timer(size_t index);
+  YASIO__DECL void sift_down_timer(size_t index);
+  void place_timer(size_t index, timer_impl_t&& timer)
   {
-    return yasio__find_if(timer_queue_, [=](const timer_impl_t& timer) { return timer.first == key; });
+    timer_queue_[index]                     = std::move(timer);
+    timer_queue_[index].timer_->heap_index_ = index;
   }
-  void sort_timers()
+  YASIO__DECL void clear_timers();
+
+  // The cross-thread command, the timer heap and channel_ops_ only modified at io thread
+  enum class command_kind : uint8_t
   {
-    std::sort(this->timer_queue_.begin(), this->timer_queue_.end(),
-              [](const timer_impl_t& lhs, const timer_impl_t& rhs) { return lhs.first->expire_time_ > rhs.first->expire_time_; });
-  }
+    SCHEDULE_TIMER,
+    CANCEL_TIMER,
+    OPEN_CHANNEL,
+    PAUSE_READ,
+    RESUME_READ,
+    JOIN_GROUP,
+    LEAVE_GROUP,
+    PUBLISH,
+    RELAY,
+  };
+  struct io_group_op {
+    std::string group;
+    shared_buffer_ptr buffer; // publish only
+    completion_cb_t handler;  // publish only
+  };
+  struct io_command {
+    command_kind kind = command_kind::SCHEDULE_TIMER;
+    highp_timer_state_ptr timer;
+    unsigned int generation   = 0; // the generation of timer when schedule posted
+    io_channel* ctx           = nullptr;
+    io_transport* transport   = nullptr;
+    unsigned int transport_id = 0; // the transport may closed and recycled before command applied
+    io_transport* peer        = nullptr; // relay only
+    unsigned int peer_id      = 0;
+    std::chrono::time_point<yasio::steady_clock_t> expire_time;
+    std::chrono::microseconds duration;
+    timer_cb_t cb;
+    std::shared_ptr<io_group_op> group_op; // the publish op shared by all loops
+
+    // the memory of recycled transport kept by tpool_, and the destructed transport is not valid
+    bool transport_open() const { return transport_open(transport, transport_id); }
+    static bool transport_open(io_transport* t, unsigned int id) { return t->is_valid() && t->id_ == id && t->is_open(); }
+  };
+  // Apply the command immediately at io thread, otherwise enqueue it to lock-free inbox, and applied by io thread
+  // once poll_io returns, the commands posted when the service not running are applied at next start
+  YASIO__DECL void post_command(io_command&& cmd);
+  YASIO__DECL void apply_command(io_command& cmd);
+  YASIO__DECL void process_commands();
+
+  // The transport groups, see io_service::join_group, service thread only
+  YASIO__DECL void post_group_command(command_kind kind, transport_handle_t thandle, cxx17::string_view group);
+  YASIO__DECL void apply_group_command(io_command& cmd);
+  YASIO__DECL void leave_groups(transport_handle_t thandle);
 
   // Start a async domain name query
   YASIO__DECL void start_query(io_channel*);
@@ -1153,6 +1615,18 @@ private:
   YASIO__DECL bool open_internal(io_channel*);
 
   YASIO__DECL void process_transports();
+  YASIO__DECL bool process_transport(transport_handle_t);
+  YASIO__DECL void collect_ready_transports();
+  YASIO__DECL bool has_channel_opmask() const;
+
+  YASIO__DECL void start_dispatchers();
+  YASIO__DECL void start_loops();
+  YASIO__DECL void stop_loops();
+  YASIO__DECL io_service* select_loop();
+  // Post accepted connection to worker loop, or the open/close operation of server channel when s is nullptr
+  YASIO__DECL void post_handoff(io_channel* source, xxsocket_ptr&& s, int opmask = 0);
+  YASIO__DECL void process_handoffs();
+  YASIO__DECL void mirror_channel(io_channel* ctx, io_channel* source);
   YASIO__DECL void process_channels();
   YASIO__DECL void process_timers();
   YASIO__DECL void process_deferred_events();
@@ -1165,6 +1639,8 @@ private:
   YASIO__DECL void do_connect(io_channel*);
   YASIO__DECL void do_connect_completion(io_channel*);
 
+  YASIO__DECL int enqueue_file(transport_handle_t thandle, int fd, bool owns_fd, int64_t offset, int64_t length, completion_cb_t&& completion_handler);
+
 #if defined(YASIO_SSL_BACKEND)
   YASIO__DECL yssl_ctx_st* init_ssl_context(ssl_role role);
   YASIO__DECL void cleanup_ssl_context(ssl_role role);
@@ -1194,22 +1670,96 @@ private:
   YASIO__DECL void run(void);
 
   YASIO__DECL bool do_read(transport_handle_t);
-  bool do_write(transport_handle_t transport) { return transport->do_write(this->wait_duration_); }
-  YASIO__DECL void unpack(transport_handle_t, int bytes_expected, int bytes_transferred, int bytes_to_strip);
+  // process the n bytes read to transport recv buffer
+  YASIO__DECL bool handle_read(transport_handle_t, int n);
+  bool do_write(transport_handle_t transport)
+  {
+    bool ok = transport->do_write(this->wait_duration_);
+    if (yasio__unlikely(transport->send_high_mark_ > 0))
+      check_send_watermarks(transport);
+    return ok;
+  }
+#if YASIO__HAS_MMSG
+  // recv at most options_.udp_batch_ datagrams to mmsg buffers with one recvmmsg
+  YASIO__DECL int recv_mmsg(xxsocket* s, int& error);
+  YASIO__DECL bool do_read_mmsg(transport_handle_t);
+#endif
+  // append the pdu bytes to expected_packet_ and fire it when completed, returns the bytes consumed
+  YASIO__DECL int unpack(transport_handle_t, const char* data, int bytes_want, int bytes_available, int bytes_to_strip);
+  // unpack all complete frames in receive ring buffer, see YOPT_C_RING_BUFFER
+  YASIO__DECL bool unpack_ring(transport_handle_t, int bytes_transferred);
+
+  // transfer the bytes of relay pair in both directions, see io_service::relay
+  YASIO__DECL bool do_relay(transport_handle_t);
+  YASIO__DECL bool start_relay(transport_handle_t);
+  YASIO__DECL bool relay_transfer(transport_handle_t source, transport_handle_t target, int& error);
 
   YASIO__DECL bool cleanup_channel(io_channel* channel, bool clear_mask = true);
   YASIO__DECL bool cleanup_io(io_base* obj, bool clear_mask = true);
 
   YASIO__DECL void handle_close(transport_handle_t);
 
+  // Notify transport needs to be visited at next event loop, thread safe
+  YASIO__DECL void notify_transport(transport_handle_t);
+  // Mark transport needs to be visited at next event loop, service thread only
+  YASIO__DECL void mark_busy(transport_handle_t);
+
+  // Swap-remove a closed transport from transports_ by it's slot
+  YASIO__DECL void remove_transport(transport_handle_t);
+
   template <typename... _Types>
   inline void fire_event(_Types&&... args)
   {
     auto event = cxx14::make_unique<io_event>(std::forward<_Types>(args)...);
     if (options_.on_defer_event_ && options_.on_defer_event_(event))
       return;
+    if (yasio__unlikely(host_))
+      return host_->post_event(std::move(event));
+    track_event(event.get());
+    if (dispatch_pool_.started())
+      return dispatch_pool_.post(dispatch_key(event.get()), std::move(event));
+    events_.emplace(std::move(event));
+  }
+  // post event from worker loop
+  void post_event(event_ptr&& event)
+  {
+    track_event(event.get());
+    if (dispatch_pool_.started())
+      return dispatch_pool_.post(dispatch_key(event.get()), std::move(event));
     events_.emplace(std::move(event));
+    if (!options_.no_dispatch_)
+      this->wakeup();
+  }
+  // the event queue backpressure, see YOPT_S_EVENT_WATERMARKS
+  io_service* event_owner() { return yasio__unlikely(host_) ? host_ : this; }
+  int64_t event_weight(io_event* event) const
+  {
+    if (!options_.event_mark_in_bytes_)
+      return 1;
+    return (event->kind() == YEK_ON_PACKET && !is_packet_empty(event->packet())) ? static_cast<int64_t>(packet_len(event->packet())) : 0;
+  }
+  void track_event(io_event* event)
+  {
+    if (options_.event_high_mark_ > 0)
+      queued_weight_ += event_weight(event);
+  }
+  bool event_queue_full()
+  {
+    auto owner = event_owner();
+    return owner->options_.event_high_mark_ > 0 && owner->queued_weight_.load(std::memory_order_relaxed) >= owner->options_.event_high_mark_;
   }
+  YASIO__DECL void untrack_events(int64_t weight);
+  YASIO__DECL void throttle_read(transport_handle_t);
+  YASIO__DECL void unthrottle_reads();
+  // Whether the transport owns the read polling of it's socket, see io_service::pause_read
+  YASIO__DECL bool read_pausable(transport_handle_t) const;
+  YASIO__DECL void set_read_paused(transport_handle_t, uint8_t reason, bool paused);
+
+  // fire YEK_ON_SEND_HIGH or YEK_ON_SEND_LOW when the queued bytes cross the watermarks
+  YASIO__DECL void check_send_watermarks(transport_handle_t);
+
+  // the dispatcher affinity of event, see YOPT_S_DISPATCH_THREADS
+  size_t dispatch_key(const io_event* event) const { return options_.dispatch_by_channel_ ? event->cindex() : event->source_id(); }
   template <typename... _Types>
   inline void forward_packet(_Types&&... args)
   {
@@ -1227,11 +1777,13 @@ private:
   // supporting server
   YASIO__DECL void do_accept(io_channel*);
   YASIO__DECL void do_accept_completion(io_channel*);
+  YASIO__DECL void handle_accept_succeed(io_channel*, xxsocket_ptr&&);
 
   /*
   ** summary: For udp-server only, make dgram handle to communicate with client
   */
   YASIO__DECL transport_handle_t do_dgram_accept(io_channel*, const ip::endpoint& peer, int& error);
+  YASIO__DECL void handle_dgram_accept(io_channel*, const ip::endpoint& peer, char* data, int n);
 
   YASIO__DECL int local_address_family() const;
 
@@ -1252,24 +1804,75 @@ private:
 
   privacy::concurrent_queue<event_ptr, true> events_;
 
+  // The events of one dispatch, only access at io_service::dispatch caller thread, see YOPT_S_BATCH_EVENT_CB
+  std::vector<event_ptr> dispatch_batch_;
+
+  // The dispatcher threads, see YOPT_S_DISPATCH_THREADS
+  dispatch_pool<event_ptr> dispatch_pool_;
+
+  // The event queue backpressure, see YOPT_S_EVENT_WATERMARKS
+  std::atomic<int64_t> queued_weight_{0}; // the weight of events not dispatched, host service only
+  std::atomic<bool> backpressure_{false};  // whether any transport read paused, host service only
+  std::vector<transport_handle_t> paused_transports_;
+
+  // The groups of transports owned by this service, see io_service::join_group
+  io_group_map groups_;
+
   std::vector<io_channel*> channels_;
 
-  std::recursive_mutex channel_ops_mtx_;
-  std::vector<io_channel*> channel_ops_;
+  std::vector<io_channel*> channel_ops_; // only access at io thread, see io_service::post_command
+
+  // The recv buffers lent to transports, see io_transport::borrow_buffer
+  recv_buffer_pool rbuf_pool_;
 
   std::vector<transport_handle_t> transports_;
   std::vector<transport_handle_t> tpool_;
   std::map<ip::endpoint, transport_handle_t> transport_map_;
 
-  // timer support timer_pair, back is earliest expire timer
+  // The ready list support, see YOPT_S_READY_LIST
+  fd_table<transport_handle_t> fd_transports_;
+  std::vector<transport_handle_t> ready_transports_;
+  std::vector<transport_handle_t> busy_transports_;
+  std::vector<transport_handle_t> pending_transports_;
+  std::mutex pending_transports_mtx_;
+  unsigned int visit_stamp_ = 0;
+
+  // The multi event loops support, see YOPT_S_IO_LOOPS
+  io_service* host_ = nullptr;       // the host service of worker loop
+  std::vector<io_service*> loops_;   // the worker loops of host service
+  unsigned int next_loop_ = 0;       // round-robin cursor
+  std::atomic<int> workload_{0};     // transports count of worker loop
+  struct handoff_t {
+    io_channel* source;
+    xxsocket_ptr socket;
+    int opmask; // the open/close operation of server channel when socket is nullptr
+  };
+  std::mutex handoff_mtx_;
+  std::vector<handoff_t> handoffs_;
+
+#if YASIO__HAS_MMSG
+  // The udp batching recv buffers, see YOPT_S_UDP_BATCH, the control buffers for UDP_GRO, see YCF_UDP_GRO
+  std::vector<struct mmsghdr> mmsg_hdrs_;
+  std::vector<struct iovec> mmsg_iovs_;
+  std::vector<ip::endpoint> mmsg_peers_;
+  std::vector<char> mmsg_buffer_;
+  std::vector<char> mmsg_controls_;
+#endif
+
+  // timer support 4-ary min heap, front is earliest expire timer
   std::vector<timer_impl_t> timer_queue_;
-  std::recursive_mutex timer_queue_mtx_;
+
+  // The commands posted by other threads
+  mpsc_queue<io_command> commands_;
 
   // the next wait duration for socket.select
   highp_time_t wait_duration_;
 
   io_watcher io_watcher_;
 
+  // Whether the io_watcher interrupted and the loop not consume it yet, the producers skip the wakeup syscall when set
+  std::atomic<bool> wakeup_pending_{false};
+
   int nsched_     = 0;
   int sched_freq_ = 5 * 60 * 1000 * 1000; // 5mins in us
 
@@ -1287,6 +1890,19 @@ private:
 
     bool no_dispatch_    = false; // since v4.0.0
     bool forward_packet_ = false; // since v3.39.8
+    bool ready_list_     = false;
+
+    int io_loops_         = 1;
+    int io_loops_balance_ = YLB_ROUND_ROBIN;
+
+    int udp_batch_ = 1;
+
+    int dispatch_threads_     = 0;
+    bool dispatch_by_channel_ = false;
+
+    int event_high_mark_      = 0;
+    int event_low_mark_       = 0;
+    bool event_mark_in_bytes_ = false;
 
 #if defined(_WIN32)
     bool hres_timer_ = false;
@@ -1306,6 +1922,8 @@ private:
     resolv_fn_t resolv_;
     // the event callback
     event_cb_t on_event_;
+    // the batch event callback, see YOPT_S_BATCH_EVENT_CB
+    batch_event_cb_t on_batch_event_;
     // The custom debug print function
     print_fn2_t print_;
 
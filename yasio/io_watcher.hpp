@@ -10,7 +10,9 @@
 
 #include "yasio/config.hpp"
 
-#if YASIO__HAS_KQUEUE && defined(YASIO_ENABLE_HPERF_IO)
+#if defined(__linux__) && defined(YASIO_ENABLE_IO_URING)
+#  include "yasio/impl/io_uring_io_watcher.hpp"
+#elif YASIO__HAS_KQUEUE && defined(YASIO_ENABLE_HPERF_IO)
 #  include "yasio/impl/kqueue_io_watcher.hpp"
 #elif YASIO__HAS_EPOLL && defined(YASIO_ENABLE_HPERF_IO)
 #  include "yasio/impl/epoll_io_watcher.hpp"
@@ -27,7 +29,9 @@ namespace yasio
 YASIO__NS_INLINE
 namespace inet
 {
-#if defined(YASIO__KQUEUE_IO_WATCHER_HPP)
+#if defined(YASIO__IO_URING_IO_WATCHER_HPP)
+using io_watcher = io_uring_io_watcher;
+#elif defined(YASIO__KQUEUE_IO_WATCHER_HPP)
 using io_watcher = kqueue_io_watcher;
 #elif defined(YASIO__EPOLL_IO_WATCHER_HPP)
 using io_watcher = epoll_io_watcher;
@@ -235,12 +235,19 @@ int xxsocket::paccept(socket_native_type& new_sock) {
   for (;;)
   {
     // Accept the waiting connection.
+#if defined(__linux__) && defined(SOCK_NONBLOCK)
+    // accept4 saves the syscalls of set_nonblocking
+    new_sock = ::accept4(this->fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
     new_sock = ::accept(this->fd, nullptr, nullptr);
+#endif
 
     // Check if operation succeeded.
     if (new_sock != invalid_socket)
     {
+#if !defined(__linux__) || !defined(SOCK_NONBLOCK)
       xxsocket::poptions(new_sock);
+#endif
       return 0;
     }
 
@@ -768,6 +775,28 @@ int xxsocket::recv_n(socket_native_type s, void* buf, int len, std::chrono::micr
 int xxsocket::send(const void* buf, int len, int flags) const { return static_cast<int>(::send(this->fd, (const char*)buf, len, flags)); }
 int xxsocket::send(socket_native_type s, const void* buf, int len, int flags) { return static_cast<int>(::send(s, (const char*)buf, len, flags)); }
 
+int xxsocket::sendv(const socket_iovec_type* iov, int iovcnt, int flags) const
+{
+#if defined(_WIN32)
+  DWORD bytes_transferred = 0;
+  if (::WSASend(this->fd, (LPWSABUF)iov, static_cast<DWORD>(iovcnt), &bytes_transferred, static_cast<DWORD>(flags), nullptr, nullptr) == 0)
+    return static_cast<int>(bytes_transferred);
+  return -1;
+#else
+  // use sendmsg instead writev, because writev doesn't support flags, i.e. MSG_NOSIGNAL
+  struct msghdr msg;
+  ::memset(&msg, 0, sizeof(msg));
+  msg.msg_iov    = const_cast<socket_iovec_type*>(iov);
+  msg.msg_iovlen = iovcnt;
+  return static_cast<int>(::sendmsg(this->fd, &msg, flags));
+#endif
+}
+
+#if YASIO__HAS_MMSG
+int xxsocket::sendmmsg(struct mmsghdr* msgvec, unsigned int vlen, int flags) const { return ::sendmmsg(this->fd, msgvec, vlen, flags); }
+int xxsocket::recvmmsg(struct mmsghdr* msgvec, unsigned int vlen, int flags) const { return ::recvmmsg(this->fd, msgvec, vlen, flags, nullptr); }
+#endif
+
 int xxsocket::recv(void* buf, int len, int flags) const { return static_cast<int>(this->recv(this->fd, buf, len, flags)); }
 int xxsocket::recv(socket_native_type s, void* buf, int len, int flags) { return static_cast<int>(::recv(s, (char*)buf, len, flags)); }
 
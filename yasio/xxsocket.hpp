@@ -832,6 +832,41 @@ public:
   YASIO__DECL int send(const void* buf, int len, int flags = 0) const;
   YASIO__DECL static int send(socket_native_type fd, const void* buf, int len, int flags = 0);
 
+  /* @brief: Sends data of multiple buffers on this connected socket with one syscall, aka gather write
+  ** @params:
+  **        iov: the buffers, fill with set_iovec
+  **        iovcnt: count of buffers
+  **
+  ** @returns:
+  **         If no error occurs, sendv returns the total number of bytes sent,
+  **         which can be less than the total length of all buffers.
+  **         Otherwise, a value of SOCKET_ERROR is returned.
+  */
+  YASIO__DECL int sendv(const socket_iovec_type* iov, int iovcnt, int flags = 0) const;
+
+#if YASIO__HAS_MMSG
+  /* @brief: Sends/Receives multiple datagrams on this socket with one syscall
+  ** @params: omit
+  **
+  ** @returns:
+  **         If no error occurs, returns the number of messages transferred,
+  **         the bytes transferred of each message stored at msgvec[i].msg_len.
+  **         Otherwise, a value of SOCKET_ERROR is returned.
+  */
+  YASIO__DECL int sendmmsg(struct mmsghdr* msgvec, unsigned int vlen, int flags = 0) const;
+  YASIO__DECL int recvmmsg(struct mmsghdr* msgvec, unsigned int vlen, int flags = 0) const;
+#endif
+  static void set_iovec(socket_iovec_type& iov, const void* buf, size_t len)
+  {
+#if defined(_WIN32)
+    iov.buf = (CHAR*)buf;
+    iov.len = static_cast<ULONG>(len);
+#else
+    iov.iov_base = (void*)buf;
+    iov.iov_len  = len;
+#endif
+  }
+
   /* @brief: Receives data from this connected socket or a bound connectionless socket.
   ** @params: omit
   **